@@ -0,0 +1,116 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Compares the two ways of checking an appinfo.json against the runner's
+// schema: validating every SAX event while parsing (json_schema::Parse(),
+// what the runner does) and parsing into a DOM first, then walking it
+// through the validator (json_schema::Accept()). Both forward the events
+// to a no-op handler, so only parsing and validation are measured.
+//
+// Built with -DBUILD_RUNNER=ON -DBUILD_RUNNER_BENCHMARKS=ON.
+//
+//   json_schema_benchmark [iterations] [appinfo.json]
+//
+// Without a file, an 800 byte appinfo.json is used.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "json_schema.h"
+
+namespace {
+
+constexpr char kAppInfo[] = R"({
+  "id": "com.webos.app.flutter.benchmark",
+  "version": "1.0.0",
+  "vendor": "LG Electronics",
+  "type": "native",
+  "main": "frontend",
+  "title": "Flutter benchmark app",
+  "icon": "icon.png",
+  "largeIcon": "icon.png",
+  "handlesRelaunch": true,
+  "defaultWindowType": "card",
+  "trustLevel": "default",
+  "resolution": "1920x1080",
+  "transparent": false,
+  "supportPortraitMode": false,
+  "nativeLifeCycleInterfaceVersion": 2,
+  "accessibility": { "supportsAudioGuidance": true },
+  "keyFilterTable": [
+    { "from": 461, "to": 27, "modifier": 0 },
+    { "from": 1536, "to": 403, "modifier": 0 }
+  ],
+  "windowGroup": {
+    "name": "benchmark",
+    "owner": true,
+    "ownerInfo": {
+      "allowAnonymous": false,
+      "layers": [ { "name": "base", "z": 0 }, { "name": "popup", "z": 100 } ]
+    }
+  }
+})";
+
+typedef rapidjson::BaseReaderHandler<> NullHandler;
+
+template <typename Function>
+double MeasureUs(long iterations, Function&& function) {
+  const auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; i++) {
+    if (!function()) {
+      fprintf(stderr, "Validation failed\n");
+      exit(1);
+    }
+  }
+  const std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / iterations;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const long iterations = argc > 1 ? atol(argv[1]) : 200000;
+  std::string json = kAppInfo;
+  if (argc > 2) {
+    std::ifstream file(argv[2]);
+    json.assign(std::istreambuf_iterator<char>(file),
+                std::istreambuf_iterator<char>());
+  }
+  if (iterations <= 0 || json.empty()) {
+    fprintf(stderr, "Usage: %s [iterations] [appinfo.json]\n", argv[0]);
+    return 1;
+  }
+
+  const rapidjson::SchemaDocument& schema = json_schema::AppInfo();
+
+  auto sax = [&schema, &json]() {
+    NullHandler handler;
+    rapidjson::StringStream is(json.c_str());
+    return json_schema::Parse<rapidjson::kParseDefaultFlags>(schema, is,
+                                                             handler, nullptr);
+  };
+  auto dom = [&schema, &json]() {
+    rapidjson::Document document;
+    document.Parse(json.c_str(), json.size());
+    if (document.HasParseError())
+      return false;
+    NullHandler handler;
+    return json_schema::Accept(schema, document, handler, nullptr);
+  };
+
+  // Warm up caches and the schema's lazily built state.
+  MeasureUs(iterations / 10 + 1, sax);
+  MeasureUs(iterations / 10 + 1, dom);
+
+  printf("%zu byte document, %ld iterations\n", json.size(), iterations);
+  printf("  SAX + schema validation       %.2f us\n", MeasureUs(iterations, sax));
+  printf("  DOM parse + Accept(validator) %.2f us\n", MeasureUs(iterations, dom));
+  return 0;
+}
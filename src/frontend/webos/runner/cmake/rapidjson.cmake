@@ -8,3 +8,11 @@ add_definitions(
   -DRAPIDJSON_HAS_CXX11_TYPETRAITS
   -DRAPIDJSON_HAS_CXX11_NOEXCEPT
 )
+
+# Pick SSE2, AVX2 or AVX-512BW parsing code at run time on x86-64 hosts.
+if(CMAKE_SYSTEM_PROCESSOR MATCHES "^(x86_64|AMD64|amd64)$")
+  add_definitions(-DRAPIDJSON_SIMD_DISPATCH)
+endif()
+
+# Hash-index the members of large objects (appinfo, settings) for lookups.
+add_definitions(-DRAPIDJSON_MEMBER_INDEX=1)
@@ -2,13 +2,25 @@ cmake_minimum_required(VERSION 3.10)
 
 # source files for user apps.
 set(USER_APP_SRCS
+  runner/environment_builder.cc
+  runner/event_loop.cc
   runner/flutter_application_description.cc
   runner/flutter_embedder_loader.cc
   runner/flutter_launch_params.cc
   runner/flutter_window.cc
+  runner/frame_pacer.cc
+  runner/json_schema.cc
+  runner/launch_envelope.cc
   runner/logger.cc
+  runner/loop_telemetry.cc
   runner/main.cc
+  runner/page_prefetcher.cc
+  runner/runner_cache.cc
+  runner/runtime_path_resolver.cc
   runner/settings.cc
+  runner/startup_orchestrator.cc
+  runner/startup_tracer.cc
+  runner/zygote.cc
 )
 
 # header files for user apps.
@@ -30,4 +42,12 @@ IF(NOT DEFINED SERVICE_NAME)
 endif(NOT DEFINED SERVICE_NAME)
 add_definitions(-DWEBOS_SERVICE_NAME="${SERVICE_NAME}")
 
+# Most verbose log level compiled in: NONE, CRITICAL, ERROR, WARNING, INFO or
+# DEBUG. Defaults to DEBUG for Debug builds and INFO otherwise.
+set(FLUTTER_LOG_LEVEL "" CACHE STRING "Runner log level compiled in")
+if(FLUTTER_LOG_LEVEL)
+  string(TOUPPER ${FLUTTER_LOG_LEVEL} FLUTTER_LOG_LEVEL_NAME)
+  add_definitions(-DFLUTTER_LOG_LEVEL=FLUTTER_LOG_LEVEL_${FLUTTER_LOG_LEVEL_NAME})
+endif()
+
 
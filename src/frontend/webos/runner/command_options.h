@@ -6,15 +6,22 @@
 #ifndef COMMAND_OPTIONS_
 #define COMMAND_OPTIONS_
 
-#include <iostream>
-#include <memory>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <deque>
+#include <functional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 #include "rapidjson/document.h"
-#include "rapidjson/writer.h"
 
 namespace commandline {
 
@@ -36,108 +43,171 @@ class Exception : public std::exception {
   std::string msg_;
 };
 
-class CommandOptions {
+enum class OptionType : uint8_t { kFlag, kInt, kDouble, kString };
+
+struct OptionSpec {
+  std::string_view name;
+  char short_name = '\0';
+  OptionType type = OptionType::kFlag;
+  std::string_view description;
+  bool required = false;
+  std::string_view default_text;
+  double default_number = 0.0;
+};
+
+constexpr OptionSpec FlagOption(std::string_view name,
+                                char short_name,
+                                std::string_view description,
+                                bool required) {
+  return {name, short_name, OptionType::kFlag, description, required, {}, 0.0};
+}
+
+constexpr OptionSpec IntOption(std::string_view name,
+                               char short_name,
+                               std::string_view description,
+                               int default_value,
+                               bool required) {
+  return {name, short_name, OptionType::kInt, description, required, {},
+          static_cast<double>(default_value)};
+}
+
+constexpr OptionSpec DoubleOption(std::string_view name,
+                                  char short_name,
+                                  std::string_view description,
+                                  double default_value,
+                                  bool required) {
+  return {name, short_name, OptionType::kDouble, description, required, {},
+          default_value};
+}
+
+constexpr OptionSpec StringOption(std::string_view name,
+                                  char short_name,
+                                  std::string_view description,
+                                  std::string_view default_value,
+                                  bool required) {
+  return {name, short_name, OptionType::kString, description, required,
+          default_value, 0.0};
+}
+
+// The option specs with their lookup tables, built at compile time:
+// long names are matched by hash first, short names index a table.
+template <size_t N>
+class OptionTable {
  public:
-  CommandOptions() = default;
-  ~CommandOptions() = default;
+  static constexpr size_t kNotFound = N;
 
-  void AddWithoutValue(const std::string& name,
-                       const std::string& short_name,
-                       const std::string& description,
-                       bool required) {
-    Add<std::string, ReaderString>(name, short_name, description, "",
-                                   ReaderString(), required, false);
+  constexpr explicit OptionTable(const OptionSpec (&specs)[N]) {
+    for (size_t i = 0; i < N; i++) {
+      specs_[i] = specs[i];
+      hashes_[i] = Hash(specs[i].name);
+    }
+    for (size_t c = 0; c < kShortNames; c++)
+      short_index_[c] = kNotFound;
+    for (size_t i = 0; i < N; i++) {
+      const unsigned char c = static_cast<unsigned char>(specs[i].short_name);
+      if (c != 0 && c < kShortNames)
+        short_index_[c] = i;
+    }
   }
 
-  void AddInt(const std::string& name,
-              const std::string& short_name,
-              const std::string& description,
-              const int& default_value,
-              bool required) {
-    Add<int, ReaderInt>(name, short_name, description, default_value,
-                        ReaderInt(), required, true);
+  // For static_assert: names are non-empty and unique, short names are
+  // unique ASCII.
+  constexpr bool IsValid() const {
+    for (size_t i = 0; i < N; i++) {
+      const unsigned char c = static_cast<unsigned char>(specs_[i].short_name);
+      if (specs_[i].name.empty() || c >= kShortNames)
+        return false;
+      for (size_t j = i + 1; j < N; j++) {
+        if (specs_[i].name == specs_[j].name ||
+            (c != 0 && specs_[i].short_name == specs_[j].short_name))
+          return false;
+      }
+    }
+    return true;
   }
 
-  void AddDouble(const std::string& name,
-              const std::string& short_name,
-              const std::string& description,
-              const double& default_value,
-              bool required) {
-    Add<double, ReaderDouble>(name, short_name, description, default_value,
-                        ReaderDouble(), required, true);
+  constexpr size_t Find(std::string_view name) const {
+    const uint32_t hash = Hash(name);
+    for (size_t i = 0; i < N; i++) {
+      if (hashes_[i] == hash && specs_[i].name == name)
+        return i;
+    }
+    return kNotFound;
   }
 
-  void AddString(const std::string& name,
-                 const std::string& short_name,
-                 const std::string& description,
-                 const std::string& default_value,
-                 bool required) {
-    Add<std::string, ReaderString>(name, short_name, description, default_value,
-                                   ReaderString(), required, true);
+  constexpr size_t FindShort(char short_name) const {
+    const unsigned char c = static_cast<unsigned char>(short_name);
+    return c != 0 && c < kShortNames ? short_index_[c] : kNotFound;
   }
 
-  template <typename T, typename F>
-  void Add(const std::string& name,
-           const std::string& short_name,
-           const std::string& description,
-           const T default_value,
-           F reader = F(),
-           bool required = true,
-           bool required_value = true) {
-    if (options_.find(name) != options_.end()) {
-      std::cerr << "Already registered option: " << name << std::endl;
-      return;
-    }
+  constexpr const OptionSpec& operator[](size_t index) const {
+    return specs_[index];
+  }
+  static constexpr size_t size() { return N; }
+
+ private:
+  static constexpr size_t kShortNames = 128;
 
-    if (lut_short_options_.find(short_name) != lut_short_options_.end()) {
-      std::cerr << short_name << "is already registered" << std::endl;
-      return;
+  static constexpr uint32_t Hash(std::string_view s) {
+    uint32_t hash = 2166136261u;
+    for (char c : s) {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 16777619u;
     }
-    lut_short_options_[short_name] = name;
+    return hash;
+  }
 
-    options_[name] = std::make_unique<OptionValueReader<T, F>>(
-        name, short_name, description, default_value, reader, required,
-        required_value);
+  OptionSpec specs_[N] = {};
+  uint32_t hashes_[N] = {};
+  size_t short_index_[kShortNames] = {};
+};
 
-    // register to show help message.
-    registration_order_options_.push_back(options_[name].get());
+// Parses argv against an OptionTable without copying the arguments:
+// values are views into argv, which must outlive this object.
+//
+// Object and array values of the JSON-style argument, e.g. appDesc and
+// params, are handed out as parsed values, see GetJson().
+template <size_t N>
+class CommandOptions {
+ public:
+  // Parses a JSON-style argument into a document owned by the callee and
+  // returns its root, or nullptr if it is not valid JSON.
+  using JsonArgumentParser =
+      std::function<const rapidjson::Value*(std::string_view json)>;
+
+  explicit CommandOptions(const OptionTable<N>& table) : table_(table) {
+    for (size_t i = 0; i < N; i++) {
+      values_[i].text = table_[i].default_text;
+      values_[i].number = table_[i].default_number;
+    }
   }
+  ~CommandOptions() = default;
+
+  // Prevent copying, values may refer to owned_.
+  CommandOptions(CommandOptions const&) = delete;
+  CommandOptions& operator=(CommandOptions const&) = delete;
 
-  bool Exist(const std::string& name) {
-    auto itr = options_.find(name);
-    return itr != options_.end() && itr->second->HasValue();
+  // By default JSON-style arguments are parsed into documents owned by
+  // this object.
+  void SetJsonArgumentParser(JsonArgumentParser parser) {
+    json_parser_ = std::move(parser);
   }
 
-  template <typename T>
-  const T& GetValue(const std::string& name) {
-    auto itr = options_.find(name);
-    if (itr == options_.end()) {
-      throw Exception("Not found: " + name);
-    }
+  bool Exist(std::string_view name) const { return values_[Index(name)].set; }
 
-    auto* option_value = dynamic_cast<const OptionValue<T>*>(itr->second.get());
-    if (!option_value) {
-      throw Exception("Type mismatch: " + name);
-    }
-    return option_value->GetValue();
+  std::string_view GetString(std::string_view name) const {
+    return Get(name, OptionType::kString).text;
   }
-
-  std::string toString(const rapidjson::Value& v) {
-    std::string value;
-
-    if (v.IsString()) {
-      value = v.GetString();
-    } else if (v.IsBool()) {
-      value = v.GetBool() ? "true" : "false";
-    } else if (v.IsInt()) {
-      value = std::to_string(v.GetInt());
-    } else if (v.IsObject()) {
-      rapidjson::StringBuffer strbuf(0, 1024); //allocate 1024byte, default 512bytes
-      rapidjson::Writer<rapidjson::StringBuffer> writer(strbuf);
-      v.Accept(writer);
-      value = strbuf.GetString();
-    }
-    return value;
+  int GetInt(std::string_view name) const {
+    return static_cast<int>(Get(name, OptionType::kInt).number);
+  }
+  double GetDouble(std::string_view name) const {
+    return Get(name, OptionType::kDouble).number;
+  }
+  // Object or array given to a string option in a JSON-style argument, or
+  // nullptr. GetString() is empty for those.
+  const rapidjson::Value* GetJson(std::string_view name) const {
+    return Get(name, OptionType::kString).json;
   }
 
   bool Parse(int argc, const char* const* argv) {
@@ -148,310 +218,265 @@ class CommandOptions {
 
     command_name_ = argv[0];
     for (auto i = 1; i < argc; i++) {
-      const std::string arg(argv[i]);
+      const std::string_view arg(argv[i]);
 
       // normal options: e.g. --bundle=/data/sample/bundle --fullscreen
       if (arg.length() > 2 &&
-          arg.substr(0, 2).compare(kOptionStyleNormal) == 0) {
-        const size_t option_value_len = arg.find("=") != std::string::npos
-                                            ? (arg.length() - arg.find("="))
-                                            : 0;
-        const bool has_value = option_value_len != 0;
-        std::string option_name =
-            arg.substr(2, arg.length() - 2 - option_value_len);
-
-        if (options_.find(option_name) == options_.end()) {
-          errors_.push_back("Not found option: " + option_name);
+          arg.compare(0, 2, kOptionStyleNormal) == 0) {
+        const size_t eq = arg.find('=');
+        const bool has_value = eq != std::string_view::npos;
+        const std::string_view option_name =
+            arg.substr(2, has_value ? eq - 2 : std::string_view::npos);
+
+        const size_t index = table_.Find(option_name);
+        if (index == table_.kNotFound) {
+          errors_.push_back("Not found option: " + std::string(option_name));
           continue;
         }
 
-        if (!has_value && options_[option_name]->IsRequiredValue()) {
-          errors_.push_back(option_name + " requres an option value");
+        if (!has_value && RequiresValue(index)) {
+          errors_.push_back(std::string(option_name) + " requres an option value");
           continue;
         }
 
-        if (has_value && !options_[option_name]->IsRequiredValue()) {
-          errors_.push_back(option_name + " doesn't requres an option value");
+        if (has_value && !RequiresValue(index)) {
+          errors_.push_back(std::string(option_name) +
+                            " doesn't requres an option value");
           continue;
         }
 
         if (has_value) {
-          SetOptionValue(option_name, arg.substr(arg.find("=") + 1));
+          SetValue(index, arg.substr(eq + 1));
         } else {
-          SetOption(option_name);
+          values_[index].set = true;
         }
       }
       // short options: e.g. -f /foo/file.txt -h 640 -abc
       else if (arg.length() > 1 &&
-               arg.substr(0, 1).compare(kOptionStyleShort) == 0) {
+               arg.compare(0, 1, kOptionStyleShort) == 0) {
         for (size_t j = 1; j < arg.length(); j++) {
-          const std::string option_name{argv[i][j]};
+          const size_t index = table_.FindShort(arg[j]);
 
-          if (lut_short_options_.find(option_name) ==
-              lut_short_options_.end()) {
-            errors_.push_back("Not found short option: " + option_name);
+          if (index == table_.kNotFound) {
+            errors_.push_back("Not found short option: " + std::string(1, arg[j]));
             break;
           }
 
-          if (j == arg.length() - 1 &&
-              options_[lut_short_options_[option_name]]->IsRequiredValue()) {
+          if (j == arg.length() - 1 && RequiresValue(index)) {
             if (i == argc - 1) {
-              errors_.push_back("Invalid format option: " + option_name);
+              errors_.push_back("Invalid format option: " + std::string(1, arg[j]));
               break;
             }
-            SetOptionValue(lut_short_options_[option_name], argv[++i]);
+            SetValue(index, argv[++i]);
           } else {
-            SetOption(lut_short_options_[option_name]);
+            values_[index].set = true;
           }
         }
       }
       // json options: e.g. flutter-client "{\"appDesc\":{\"id\":\"com.webos.app.flutter.gallery\"}, \"params\":{\"displayAffinity\":0}}"
       else if (arg.length() > 1 &&
-            arg.substr(0,1).compare(kOptionStyleJson) == 0) {
-        rapidjson::Document doc;
-        doc.Parse(arg.c_str());
-
-        if (doc.HasParseError()) {
-          errors_.push_back("Invalid JSON-format parse error: " + arg);
+               arg.compare(0, 1, kOptionStyleJson) == 0) {
+        const rapidjson::Value* root = ParseJson(arg);
+        if (!root || !root->IsObject()) {
+          errors_.push_back("Invalid JSON-format parse error: " + std::string(arg));
           continue;
         }
-
-        std::string option_name;
-        bool has_value;
-
-        for (auto& m : doc.GetObject()) {
-          option_name = m.name.GetString();
-          has_value = !m.value.IsNull();
-          if (options_.find(option_name) == options_.end()) {
-            continue;
-          }
-
-          if (!has_value && options_[option_name]->IsRequiredValue()) {
-            errors_.push_back(option_name + " requres an option value");
-            break;
-          }
-
-          if (has_value && !options_[option_name]->IsRequiredValue()) {
-            errors_.push_back(option_name + " doesn't requres an option value");
-            continue;
-          }
-
-          if (has_value) {
-            SetOptionValue(option_name, toString(m.value));
-          }
-        }
+        SetJsonValues(*root);
       } else {
-        errors_.push_back("Invalid format option: " + arg);
+        errors_.push_back("Invalid format option: " + std::string(arg));
       }
     }
 
-    for (size_t i = 0; i < registration_order_options_.size(); i++) {
-      if (registration_order_options_[i]->IsRequired() &&
-          !registration_order_options_[i]->HasValue()) {
-        errors_.push_back(
-            std::string(registration_order_options_[i]->GetName()) +
-            " option is mandatory.");
+    for (size_t i = 0; i < N; i++) {
+      if (table_[i].required && !values_[i].set) {
+        errors_.push_back(std::string(table_[i].name) + " option is mandatory.");
       }
     }
 
     return errors_.size() == 0;
   }
 
-  std::string GetError() { return errors_.size() > 0 ? errors_[0] : ""; }
+  std::string GetError() const { return errors_.size() > 0 ? errors_[0] : ""; }
 
-  std::vector<std::string>& GetErrors() { return errors_; }
+  const std::vector<std::string>& GetErrors() const { return errors_; }
 
-  std::string ShowHelp() {
+  std::string ShowHelp() const {
     std::ostringstream ostream;
 
     ostream << "Usage: " << command_name_ << " ";
-    for (size_t i = 0; i < registration_order_options_.size(); i++) {
-      if (registration_order_options_[i]->IsRequired()) {
-        ostream << registration_order_options_[i]->GetHelpShortMessage() << " ";
+    for (size_t i = 0; i < N; i++) {
+      if (table_[i].required) {
+        ostream << kOptionStyleNormal << table_[i].name;
+        if (RequiresValue(i)) {
+          ostream << kOptionValueForHelpMessage;
+        }
+        ostream << " ";
       }
     }
     ostream << std::endl;
 
     ostream << "Global options:" << std::endl;
     size_t max_name_len = 0;
-    for (size_t i = 0; i < registration_order_options_.size(); i++) {
-      max_name_len = std::max(
-          max_name_len, registration_order_options_[i]->GetName().length());
+    for (size_t i = 0; i < N; i++) {
+      max_name_len = std::max(max_name_len, table_[i].name.length());
     }
 
-    for (size_t i = 0; i < registration_order_options_.size(); i++) {
-      if (!registration_order_options_[i]->GetShortName().empty()) {
-        ostream << kOptionStyleShort
-                << registration_order_options_[i]->GetShortName() << ", ";
+    for (size_t i = 0; i < N; i++) {
+      if (table_[i].short_name != '\0') {
+        ostream << kOptionStyleShort << table_[i].short_name << ", ";
       } else {
         ostream << std::string(4, ' ');
       }
 
       size_t index_adjust = 0;
       constexpr int kSpacerNum = 10;
-      auto need_value = registration_order_options_[i]->IsRequiredValue();
-      ostream << kOptionStyleNormal
-              << registration_order_options_[i]->GetName();
-      if (need_value) {
+      ostream << kOptionStyleNormal << table_[i].name;
+      if (RequiresValue(i)) {
         ostream << kOptionValueForHelpMessage;
-        index_adjust += std::string(kOptionValueForHelpMessage).length();
+        index_adjust += sizeof(kOptionValueForHelpMessage) - 1;
       }
       ostream << std::string(
-          max_name_len + kSpacerNum - index_adjust -
-              registration_order_options_[i]->GetName().length(),
+          max_name_len + kSpacerNum - index_adjust - table_[i].name.length(),
           ' ');
-      ostream << registration_order_options_[i]->GetDescription() << std::endl;
+      ostream << table_[i].description << std::endl;
     }
 
     return ostream.str();
   }
 
  private:
-  struct ReaderInt {
-    int operator()(const std::string& value) { return std::stoi(value); }
+  struct Value {
+    bool set = false;
+    std::string_view text;
+    double number = 0.0;
+    const rapidjson::Value* json = nullptr;
   };
 
-  struct ReaderString {
-    std::string operator()(const std::string& value) { return value; }
-  };
-
-  struct ReaderDouble {
-    double operator()(const std::string& value) { return std::stod(value); }
-  };
-
-  class Option {
-   public:
-    Option(const std::string& name,
-           const std::string& short_name,
-           const std::string& description,
-           bool required,
-           bool required_value)
-        : name_(name),
-          short_name_(short_name),
-          description_(description),
-          is_required_(required),
-          is_required_value_(required_value),
-          value_set_(false){};
-    virtual ~Option() = default;
-
-    const std::string& GetName() const { return name_; };
-
-    const std::string& GetShortName() const { return short_name_; };
-
-    const std::string& GetDescription() const { return description_; };
-
-    const std::string GetHelpShortMessage() const {
-      std::string message = kOptionStyleNormal + name_;
-      if (is_required_value_) {
-        message += kOptionValueForHelpMessage;
-      }
-      return message;
+  size_t Index(std::string_view name) const {
+    const size_t index = table_.Find(name);
+    if (index == table_.kNotFound) {
+      throw Exception("Not found: " + std::string(name));
     }
+    return index;
+  }
 
-    bool IsRequired() const { return is_required_; };
-
-    bool IsRequiredValue() const { return is_required_value_; };
-
-    void Set() { value_set_ = true; };
-
-    virtual bool SetValue(const std::string& value) = 0;
-
-    virtual bool HasValue() const = 0;
-
-   protected:
-    std::string name_;
-    std::string short_name_;
-    std::string description_;
-    bool is_required_;
-    bool is_required_value_;
-    bool value_set_;
-  };
-
-  template <typename T>
-  class OptionValue : public Option {
-   public:
-    OptionValue(const std::string& name,
-                const std::string& short_name,
-                const std::string& description,
-                const T& default_value,
-                bool required,
-                bool required_value)
-        : Option(name, short_name, description, required, required_value),
-          default_value_(default_value),
-          value_(default_value){};
-    virtual ~OptionValue() = default;
-
-    bool SetValue(const std::string& value) {
-      value_ = Read(value);
-      value_set_ = true;
-      return true;
+  const Value& Get(std::string_view name, OptionType type) const {
+    const size_t index = Index(name);
+    if (table_[index].type != type) {
+      throw Exception("Type mismatch: " + std::string(name));
     }
+    return values_[index];
+  }
 
-    bool HasValue() const { return value_set_; }
+  bool RequiresValue(size_t index) const {
+    return table_[index].type != OptionType::kFlag;
+  }
 
-    const T& GetValue() const { return value_; }
+  const rapidjson::Value* ParseJson(std::string_view json) {
+    if (json_parser_)
+      return json_parser_(json);
+    rapidjson::Document& document = documents_.emplace_back();
+    document.Parse(json.data(), json.size());
+    return document.HasParseError() ? nullptr : &document;
+  }
 
-   protected:
-    virtual T Read(const std::string& s) = 0;
+  // Assigns the members of a JSON-style argument to the options of the
+  // same name. Members not naming an option are skipped.
+  void SetJsonValues(const rapidjson::Value& object) {
+    for (const auto& member : object.GetObject()) {
+      const std::string_view name(member.name.GetString(),
+                                  member.name.GetStringLength());
+      const size_t index = table_.Find(name);
+      if (index == table_.kNotFound) {
+        continue;
+      }
 
-    T default_value_;
-    T value_;
-  };
+      const rapidjson::Value& value = member.value;
+      if (value.IsNull() && RequiresValue(index)) {
+        errors_.push_back(std::string(name) + " requres an option value");
+        break;
+      }
 
-  template <typename T, typename F>
-  class OptionValueReader : public OptionValue<T> {
-   public:
-    OptionValueReader(const std::string& name,
-                      const std::string& short_name,
-                      const std::string& description,
-                      const T default_value,
-                      F reader,
-                      bool required,
-                      bool required_value)
-        : OptionValue<T>(name,
-                         short_name,
-                         description,
-                         default_value,
-                         required,
-                         required_value),
-          reader_(reader) {}
-    ~OptionValueReader() = default;
-
-   private:
-    T Read(const std::string& value) { return reader_(value); }
-
-    F reader_;
-  };
+      if (!value.IsNull() && !RequiresValue(index)) {
+        errors_.push_back(std::string(name) + " doesn't requres an option value");
+        continue;
+      }
 
-  bool SetOption(const std::string& name) {
-    auto itr = options_.find(name);
-    if (itr == options_.end()) {
-      errors_.push_back("Unknown option: " + name);
-      return false;
+      if (value.IsString()) {
+        SetValue(index, std::string_view(value.GetString(), value.GetStringLength()));
+      } else if (value.IsBool()) {
+        SetValue(index, value.GetBool() ? "true" : "false");
+      } else if (value.IsNumber()) {
+        owned_.push_back(NumberText(value));
+        SetValue(index, owned_.back());
+      } else if (value.IsObject() || value.IsArray()) {
+        if (table_[index].type != OptionType::kString) {
+          errors_.push_back("Invalid option value: " + std::string(name));
+          continue;
+        }
+        values_[index].text = std::string_view();
+        values_[index].json = &value;
+        values_[index].set = true;
+      }
     }
+  }
 
-    itr->second->Set();
-    return true;
+  static std::string NumberText(const rapidjson::Value& value) {
+    if (value.IsInt64())
+      return std::to_string(value.GetInt64());
+    if (value.IsUint64())
+      return std::to_string(value.GetUint64());
+    std::ostringstream text;
+    text.precision(17);
+    text << value.GetDouble();
+    return text.str();
   }
 
-  bool SetOptionValue(const std::string& name, const std::string& value) {
-    auto itr = options_.find(name);
-    if (itr == options_.end()) {
-      errors_.push_back("Unknown option: " + name);
-      return false;
+  bool SetValue(size_t index, std::string_view text) {
+    Value& value = values_[index];
+    const OptionType type = table_[index].type;
+    if (type == OptionType::kInt || type == OptionType::kDouble) {
+      if (!ParseNumber(text, type, &value.number)) {
+        errors_.push_back("Invalid option value: " + std::string(table_[index].name) +
+                          " = " + std::string(text));
+        return false;
+      }
     }
+    value.text = text;
+    value.json = nullptr;
+    value.set = true;
+    return true;
+  }
 
-    if (!itr->second->SetValue(value)) {
-      errors_.push_back("Invalid option value: " + name + " = " + value);
+  static bool ParseNumber(std::string_view text, OptionType type, double* out) {
+    // Values are not necessarily terminated, e.g. JSON slices.
+    char buffer[64];
+    if (text.empty() || text.size() >= sizeof(buffer))
       return false;
+    memcpy(buffer, text.data(), text.size());
+    buffer[text.size()] = '\0';
+
+    char* end = nullptr;
+    errno = 0;
+    if (type == OptionType::kInt) {
+      const long value = strtol(buffer, &end, 10);
+      if (value < INT_MIN || value > INT_MAX)
+        return false;
+      *out = static_cast<double>(value);
+    } else {
+      *out = strtod(buffer, &end);
     }
-    return true;
+    return errno == 0 && end == buffer + text.size();
   }
 
-  std::string command_name_;
-  std::unordered_map<std::string, std::unique_ptr<Option>> options_;
-  std::unordered_map<std::string, std::string> lut_short_options_;
-  std::vector<Option*> registration_order_options_;
+  const OptionTable<N>& table_;
+  std::array<Value, N> values_;
+  std::string_view command_name_;
+  JsonArgumentParser json_parser_;
+  // Used without a JsonArgumentParser.
+  std::deque<rapidjson::Document> documents_;
+  // Values converted from JSON numbers. A deque keeps them in place.
+  std::deque<std::string> owned_;
   std::vector<std::string> errors_;
 };
 
@@ -0,0 +1,63 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "environment_builder.h"
+
+#include <unistd.h>
+
+#include "logger.h"
+
+extern char** environ;
+
+void EnvironmentBuilder::Add(std::string_view name, std::string_view value) {
+  if (name.empty() || name.find('=') != std::string_view::npos) {
+    LOG_WARNING("Invalid environment variable name: %.*s",
+                static_cast<int>(name.size()), name.data());
+    return;
+  }
+
+  std::string key(name);
+  if (!m_pendingNames.insert(key).second)
+    return;
+
+  key += '=';
+  key.append(value.data(), value.size());
+  m_pending.push_back(std::move(key));
+}
+
+void EnvironmentBuilder::Commit() {
+  if (m_pending.empty())
+    return;
+
+  std::unordered_set<std::string_view> existing;
+  size_t count = 0;
+  for (char** env = environ; env && *env; env++, count++) {
+    std::string_view entry(*env);
+    existing.insert(entry.substr(0, entry.find('=')));
+  }
+
+  // Intentionally leaked: other threads, e.g. a library constructor running
+  // on the preload thread, may still be walking the previous block.
+  char** block = new char*[count + m_pending.size() + 1];
+  for (size_t i = 0; i < count; i++)
+    block[i] = environ[i];
+
+  size_t added = 0;
+  for (std::string& entry : m_pending) {
+    std::string_view name(entry.data(), entry.find('='));
+    if (existing.count(name))
+      continue;
+    m_committed.push_back(std::move(entry));
+    block[count + added++] = &m_committed.back()[0];
+  }
+  block[count + added] = nullptr;
+
+  m_pending.clear();
+  m_pendingNames.clear();
+  if (added == 0) {
+    delete[] block;
+    return;
+  }
+  environ = block;
+}
@@ -0,0 +1,46 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_RUNNER_ENVIRONMENT_BUILDER_H_
+#define FLUTTER_RUNNER_ENVIRONMENT_BUILDER_H_
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// Collects environment variables and installs them with a single swap of
+// |environ|, instead of one setenv() per variable, each of which scans and
+// copies the whole environment under the glibc environment lock.
+//
+// Semantics match setenv(name, value, 0): the first value staged for a
+// name wins, and a name already present in the environment at Commit()
+// time is left untouched.
+class EnvironmentBuilder {
+ public:
+  EnvironmentBuilder() {}
+
+  // Prevent copying.
+  EnvironmentBuilder(EnvironmentBuilder const&) = delete;
+  EnvironmentBuilder& operator=(EnvironmentBuilder const&) = delete;
+
+  void Add(std::string_view name, std::string_view value);
+
+  // Builds a new environment block from the current |environ| plus the
+  // staged variables and installs it. Not thread-safe against concurrent
+  // setenv()/putenv() calls, like setenv() itself.
+  void Commit();
+
+  size_t PendingCount() const { return m_pending.size(); }
+
+ private:
+  std::vector<std::string> m_pending;  // "NAME=value"
+  std::unordered_set<std::string> m_pendingNames;
+  // Strings referenced by installed blocks. Like the blocks themselves they
+  // are never freed, since getenv() callers may still hold pointers.
+  std::deque<std::string> m_committed;
+};
+
+#endif  // FLUTTER_RUNNER_ENVIRONMENT_BUILDER_H_
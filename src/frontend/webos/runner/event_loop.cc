@@ -0,0 +1,127 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "event_loop.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "logger.h"
+
+namespace {
+constexpr int kMaxEvents = 8;
+}  // namespace
+
+EventLoop::~EventLoop() {
+  if (wake_fd_ >= 0)
+    close(wake_fd_);
+  if (timer_fd_ >= 0)
+    close(timer_fd_);
+  if (epoll_fd_ >= 0)
+    close(epoll_fd_);
+}
+
+bool EventLoop::Init() {
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd_ < 0) {
+    LOG_ERROR("epoll_create1 failed: %s", strerror(errno));
+    return false;
+  }
+
+  // std::chrono::steady_clock is CLOCK_MONOTONIC on Linux, so deadlines can
+  // be passed to the timer as absolute values without conversion.
+  timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (timer_fd_ < 0 || !AddWatch(timer_fd_)) {
+    LOG_ERROR("timerfd_create failed: %s", strerror(errno));
+    return false;
+  }
+
+  wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wake_fd_ < 0 || !AddWatch(wake_fd_)) {
+    LOG_ERROR("eventfd failed: %s", strerror(errno));
+    return false;
+  }
+
+  return true;
+}
+
+bool EventLoop::AddWatch(int fd) {
+  struct epoll_event ev = {};
+  ev.events = EPOLLIN;
+  ev.data.fd = fd;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+    LOG_WARNING("epoll_ctl(%d) failed: %s", fd, strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+void EventLoop::Wake() {
+  uint64_t one = 1;
+  if (write(wake_fd_, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+    LOG_WARNING("Failed to wake event loop: %s", strerror(errno));
+  }
+}
+
+bool EventLoop::ArmTimer(Clock::time_point deadline) {
+  if (deadline == armed_deadline_)
+    return true;
+
+  struct itimerspec spec = {};
+  if (deadline != Clock::time_point::max()) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  deadline.time_since_epoch())
+                  .count();
+    spec.it_value.tv_sec = ns / 1000000000;
+    spec.it_value.tv_nsec = ns % 1000000000;
+  }
+  // A zero it_value disarms the timer.
+  if (timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) {
+    LOG_ERROR("timerfd_settime failed: %s", strerror(errno));
+    return false;
+  }
+  armed_deadline_ = deadline;
+  return true;
+}
+
+int EventLoop::WaitUntil(Clock::time_point deadline) {
+  if (deadline <= Clock::now())
+    return kWakeTimeout;
+
+  if (!ArmTimer(deadline))
+    return kWakeNone;
+
+  struct epoll_event events[kMaxEvents];
+  int count = epoll_wait(epoll_fd_, events, kMaxEvents, -1);
+  if (count < 0) {
+    if (errno != EINTR)
+      LOG_ERROR("epoll_wait failed: %s", strerror(errno));
+    return kWakeInterrupted;
+  }
+
+  int reason = kWakeNone;
+  for (int i = 0; i < count; i++) {
+    uint64_t value;
+    if (events[i].data.fd == timer_fd_) {
+      if (read(timer_fd_, &value, sizeof(value)) > 0) {
+        // The timer is one-shot; it is disarmed once it has expired.
+        armed_deadline_ = Clock::time_point::min();
+      }
+      reason |= kWakeTimeout;
+    } else if (events[i].data.fd == wake_fd_) {
+      if (read(wake_fd_, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+        LOG_WARNING("Failed to drain wake fd: %s", strerror(errno));
+      }
+      reason |= kWakeInterrupted;
+    } else {
+      reason |= kWakeReadable;
+    }
+  }
+  return reason;
+}
@@ -0,0 +1,60 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_RUNNER_EVENT_LOOP_H_
+#define FLUTTER_RUNNER_EVENT_LOOP_H_
+
+#include <chrono>
+
+// epoll based reactor for the runner main loop.
+//
+// Waits on the watched file descriptors (e.g. the display connection) and a
+// timerfd armed at an absolute CLOCK_MONOTONIC deadline, so wakeups keep
+// nanosecond precision instead of being truncated to milliseconds.
+class EventLoop {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  enum WakeReason {
+    kWakeNone = 0x00,
+    kWakeTimeout = 0x01,
+    kWakeReadable = 0x02,
+    kWakeInterrupted = 0x04,
+  };
+
+  EventLoop() = default;
+  ~EventLoop();
+
+  // Prevent copying.
+  EventLoop(EventLoop const&) = delete;
+  EventLoop& operator=(EventLoop const&) = delete;
+
+  bool Init();
+  bool IsValid() const { return epoll_fd_ >= 0 && timer_fd_ >= 0; }
+
+  // Adds |fd| to the level-triggered read set.
+  bool AddWatch(int fd);
+
+  // Wakes a thread blocked in WaitUntil(). Safe to call from any thread.
+  void Wake();
+
+  // The eventfd behind Wake(). Signal handlers, where Wake() is not safe
+  // since it may log, write an 8-byte counter to it instead.
+  int wake_fd() const { return wake_fd_; }
+
+  // Blocks until |deadline| passes, a watched fd becomes readable or Wake()
+  // is called. Clock::time_point::max() disarms the timer and waits without
+  // a timeout. Returns a mask of WakeReason.
+  int WaitUntil(Clock::time_point deadline);
+
+ private:
+  bool ArmTimer(Clock::time_point deadline);
+
+  int epoll_fd_ = -1;
+  int timer_fd_ = -1;
+  int wake_fd_ = -1;
+  Clock::time_point armed_deadline_ = Clock::time_point::min();
+};
+
+#endif  // FLUTTER_RUNNER_EVENT_LOOP_H_
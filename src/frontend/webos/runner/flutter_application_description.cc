@@ -4,19 +4,27 @@
 
 #include "flutter_application_description.h"
 
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
-#include <fstream>
-#include <iostream>
+#include <climits>
 #include <limits>
 #include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
 #include <vector>
 
-#include "rapidjson/document.h"
+#include "rapidjson/memorystream.h"
 
+#include "json_schema.h"
 #include "logger.h"
+#include "runner_cache.h"
 
 bool FlutterApplicationDescription::CheckTrustLevel(std::string trust_level) {
   if (trust_level.empty())
@@ -58,6 +66,185 @@ const std::string WindowTypeFromString(const std::string& str) {
   return "_WEBOS_WINDOW_TYPE_CARD";
 }
 
+namespace {
+
+// Keys of appinfo.json known to the decoder, at any nesting level.
+enum class AppInfoKey {
+  kUnknown,
+  kId,
+  kType,
+  kTransparent,
+  kTrustLevel,
+  kDefaultWindowType,
+  kNativeLifeCycleInterfaceVersion,
+  kVersion,
+  kDisableBackHistoryAPI,
+  kIcon,
+  kFolderPath,
+  kTitle,
+  kHandleExitKey,
+  kSupportPortraitMode,
+  kEnableKeyboard,
+  kLocationHint,
+  kHandlesRelaunch,
+  kCloudgameActive,
+  kMain,
+  kAccessibility,
+  kSupportsAudioGuidance,
+  kResolution,
+  kKeyFilterTable,
+  kFrom,
+  kTo,
+  kModifier,
+  kClass,
+  kHidden,
+  kWindowGroup,
+  kName,
+  kOwner,
+  kOwnerInfo,
+  kAllowAnonymous,
+  kLayers,
+  kZ,
+  kClientInfo,
+  kLayer,
+};
+
+constexpr uint32_t KeyHash(std::string_view key) {
+  uint32_t hash = 2166136261u;
+  for (char c : key) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// The hash is perfect on the known keys: a collision would not compile as
+// it makes two case labels equal. One compare rejects unknown keys.
+AppInfoKey LookupKey(std::string_view key) {
+#define APPINFO_KEY(name, value) \
+  case KeyHash(name):            \
+    return key == name ? AppInfoKey::value : AppInfoKey::kUnknown
+
+  switch (KeyHash(key)) {
+    APPINFO_KEY("id", kId);
+    APPINFO_KEY("type", kType);
+    APPINFO_KEY("transparent", kTransparent);
+    APPINFO_KEY("trustLevel", kTrustLevel);
+    APPINFO_KEY("defaultWindowType", kDefaultWindowType);
+    APPINFO_KEY("nativeLifeCycleInterfaceVersion", kNativeLifeCycleInterfaceVersion);
+    APPINFO_KEY("version", kVersion);
+    APPINFO_KEY("disableBackHistoryAPI", kDisableBackHistoryAPI);
+    APPINFO_KEY("icon", kIcon);
+    APPINFO_KEY("folderPath", kFolderPath);
+    APPINFO_KEY("title", kTitle);
+    APPINFO_KEY("handleExitKey", kHandleExitKey);
+    APPINFO_KEY("supportPortraitMode", kSupportPortraitMode);
+    APPINFO_KEY("enableKeyboard", kEnableKeyboard);
+    APPINFO_KEY("locationHint", kLocationHint);
+    APPINFO_KEY("handlesRelaunch", kHandlesRelaunch);
+    APPINFO_KEY("cloudgame_active", kCloudgameActive);
+    APPINFO_KEY("main", kMain);
+    APPINFO_KEY("accessibility", kAccessibility);
+    APPINFO_KEY("supportsAudioGuidance", kSupportsAudioGuidance);
+    APPINFO_KEY("resolution", kResolution);
+    APPINFO_KEY("keyFilterTable", kKeyFilterTable);
+    APPINFO_KEY("from", kFrom);
+    APPINFO_KEY("to", kTo);
+    APPINFO_KEY("modifier", kModifier);
+    APPINFO_KEY("class", kClass);
+    APPINFO_KEY("hidden", kHidden);
+    APPINFO_KEY("windowGroup", kWindowGroup);
+    APPINFO_KEY("name", kName);
+    APPINFO_KEY("owner", kOwner);
+    APPINFO_KEY("ownerInfo", kOwnerInfo);
+    APPINFO_KEY("allowAnonymous", kAllowAnonymous);
+    APPINFO_KEY("layers", kLayers);
+    APPINFO_KEY("z", kZ);
+    APPINFO_KEY("clientInfo", kClientInfo);
+    APPINFO_KEY("layer", kLayer);
+    default:
+      return AppInfoKey::kUnknown;
+  }
+
+#undef APPINFO_KEY
+}
+
+// Compiled appinfo.json record, bump kRecordVersion on any layout change.
+constexpr char kRecordMagic[4] = {'F', 'L', 'A', 'D'};
+constexpr uint32_t kRecordVersion = 3;
+
+FlutterApplicationDescription::CacheStats g_cache_stats = {0, 0, 0};
+
+class RecordWriter {
+ public:
+  explicit RecordWriter(std::string* out) : out_(out) {}
+
+  void U32(uint32_t v) { out_->append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+  void U64(uint64_t v) { out_->append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+  void I32(int32_t v) { U32(static_cast<uint32_t>(v)); }
+  void Bool(bool v) { out_->push_back(v ? 1 : 0); }
+  void String(const std::string& v) {
+    U32(static_cast<uint32_t>(v.size()));
+    out_->append(v);
+  }
+
+ private:
+  std::string* out_;
+};
+
+// Reads past the end yield zeros and clear Ok().
+class RecordReader {
+ public:
+  RecordReader(const std::string& data, size_t offset)
+      : data_(data), offset_(offset) {}
+
+  bool Ok() const { return ok_; }
+  bool AtEnd() const { return offset_ == data_.size(); }
+
+  uint32_t U32() {
+    uint32_t v = 0;
+    Read(&v, sizeof(v));
+    return v;
+  }
+  uint64_t U64() {
+    uint64_t v = 0;
+    Read(&v, sizeof(v));
+    return v;
+  }
+  int32_t I32() { return static_cast<int32_t>(U32()); }
+  bool Bool() {
+    char v = 0;
+    Read(&v, sizeof(v));
+    return v != 0;
+  }
+  std::string String() {
+    uint32_t size = U32();
+    if (!ok_ || size > data_.size() - offset_) {
+      ok_ = false;
+      return std::string();
+    }
+    std::string v = data_.substr(offset_, size);
+    offset_ += size;
+    return v;
+  }
+
+ private:
+  void Read(void* v, size_t size) {
+    if (!ok_ || size > data_.size() - offset_) {
+      ok_ = false;
+      return;
+    }
+    memcpy(v, data_.data() + offset_, size);
+    offset_ += size;
+  }
+
+  const std::string& data_;
+  size_t offset_;
+  bool ok_ = true;
+};
+
+}  // namespace
+
 FlutterApplicationDescription::FlutterApplicationDescription()
     : transparency_(false),
       window_class_value_(kWindowClassNormal),
@@ -78,196 +265,653 @@ FlutterApplicationDescription::FlutterApplicationDescription()
       is_privileged_(false) {}
 
 
-std::unique_ptr<FlutterApplicationDescription> FlutterApplicationDescription::FromAppInfo(const char* bundlePath)
-{
-    std::string pathAppInfo = std::string(bundlePath) + "/appinfo.json";
+// Fills the descriptor fields straight from the rapidjson SAX events.
+//
+// Containers the descriptor does not know are skipped, and the first of
+// duplicated top-level keys wins, as with the DOM lookups this replaces.
+// Documents not matching the appinfo schema are rejected by the validator
+// in front of the decoder; values of an unexpected type are still ignored
+// here rather than trusted. Fields depending on each
+// other regardless of their order in the file, like windowGroup "owner"
+// and its "ownerInfo"/"clientInfo", are resolved in Finish().
+class FlutterApplicationDescription::Decoder
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, Decoder> {
+ public:
+  explicit Decoder(FlutterApplicationDescription* desc) : desc_(desc) {}
+
+  bool IsObject() const { return is_object_; }
+  void Finish();
+
+  bool Default();
+  bool Bool(bool b);
+  bool Int(int i);
+  bool Uint(unsigned u);
+  bool String(const char* str, rapidjson::SizeType length, bool copy);
+  bool StartObject();
+  bool Key(const char* str, rapidjson::SizeType length, bool copy);
+  bool EndObject(rapidjson::SizeType member_count);
+  bool StartArray();
+  bool EndArray(rapidjson::SizeType element_count);
+
+ private:
+  enum Scope : uint8_t {
+    kRoot,
+    kAccessibility,
+    kClass,
+    kWindowGroup,
+    kOwnerInfo,
+    kClientInfo,
+    kLayers,
+    kLayerItem,
+    kKeyFilterTable,
+    kKeyFilterItem,
+  };
+  // Deeper than any known scope, so pushes never overflow.
+  static constexpr int kMaxDepth = 8;
+
+  Scope Top() const { return scopes_[depth_ - 1]; }
+  void Push(Scope scope) { scopes_[depth_++] = scope; }
+  // Common prologue of the scalar handlers. False if the value is to be
+  // ignored.
+  bool Accept() const { return skip_depth_ == 0 && depth_ > 0; }
+
+  FlutterApplicationDescription* desc_;
+
+  Scope scopes_[kMaxDepth];
+  int depth_ = 0;
+  int skip_depth_ = 0;
+  AppInfoKey key_ = AppInfoKey::kUnknown;
+  uint64_t seen_ = 0;
+  bool is_object_ = false;
+
+  std::string default_window_type_;
+  bool has_resolution_ = false;
+  std::string resolution_;
+
+  bool has_group_name_ = false;
+  std::string group_name_;
+  bool has_group_owner_ = false;
+  bool group_owner_ = false;
+  bool allow_anonymous_ = false;
+  std::vector<std::pair<std::string, int>> owner_layers_;
+  bool has_client_layer_ = false;
+  std::string client_layer_;
+
+  // Members of the current keyFilterTable or layers item.
+  bool has_from_, has_to_, has_modifier_;
+  int from_, to_, modifier_;
+  bool has_layer_name_, has_z_;
+  std::string layer_name_;
+  int z_;
+};
+
+bool FlutterApplicationDescription::Decoder::Default() {
+  // A scalar root is not an appinfo object.
+  if (skip_depth_ == 0 && depth_ == 0)
+    return false;
+  key_ = AppInfoKey::kUnknown;
+  return true;
+}
+
+bool FlutterApplicationDescription::Decoder::Bool(bool b) {
+  if (!Accept())
+    return Default();
+
+  switch (Top()) {
+    case kRoot:
+      switch (key_) {
+        case AppInfoKey::kTransparent: desc_->transparency_ = b; break;
+        case AppInfoKey::kDisableBackHistoryAPI: desc_->back_history_api_disabled_ = b; break;
+        case AppInfoKey::kHandleExitKey: desc_->handle_exit_key_ = b; break;
+        case AppInfoKey::kSupportPortraitMode: desc_->support_portrait_mode_ = b; break;
+        case AppInfoKey::kEnableKeyboard: desc_->use_virtual_keyboard_ = b; break;
+        case AppInfoKey::kHandlesRelaunch: desc_->handles_relaunch_ = b; break;
+        case AppInfoKey::kCloudgameActive: desc_->cloudgame_active_ = b; break;
+        default: break;
+      }
+      break;
+    case kAccessibility:
+      if (key_ == AppInfoKey::kSupportsAudioGuidance)
+        desc_->supports_audio_guidance_ = b;
+      break;
+    case kClass:
+      if (key_ == AppInfoKey::kHidden && b)
+        desc_->window_class_value_ = kWindowClassHidden;
+      break;
+    case kWindowGroup:
+      if (key_ == AppInfoKey::kOwner) {
+        has_group_owner_ = true;
+        group_owner_ = b;
+      }
+      break;
+    case kOwnerInfo:
+      if (key_ == AppInfoKey::kAllowAnonymous)
+        allow_anonymous_ = b;
+      break;
+    default:
+      break;
+  }
+  key_ = AppInfoKey::kUnknown;
+  return true;
+}
+
+bool FlutterApplicationDescription::Decoder::Int(int i) {
+  if (!Accept())
+    return Default();
+
+  switch (Top()) {
+    case kRoot:
+      if (key_ == AppInfoKey::kNativeLifeCycleInterfaceVersion)
+        desc_->native_lifecycle_interface_version_ = i;
+      break;
+    case kKeyFilterItem:
+      if (key_ == AppInfoKey::kFrom) {
+        has_from_ = true;
+        from_ = i;
+      } else if (key_ == AppInfoKey::kTo) {
+        has_to_ = true;
+        to_ = i;
+      } else if (key_ == AppInfoKey::kModifier) {
+        has_modifier_ = true;
+        modifier_ = i;
+      }
+      break;
+    case kLayerItem:
+      if (key_ == AppInfoKey::kZ) {
+        has_z_ = true;
+        z_ = i;
+      }
+      break;
+    default:
+      break;
+  }
+  key_ = AppInfoKey::kUnknown;
+  return true;
+}
 
-    std::ifstream fileAppInfo(pathAppInfo, std::ios::in);
-    std::string appInfo = "{}";
+bool FlutterApplicationDescription::Decoder::Uint(unsigned u) {
+  // Non-negative numbers are reported as unsigned.
+  if (u <= static_cast<unsigned>(INT_MAX))
+    return Int(static_cast<int>(u));
+  return Default();
+}
 
-    if (fileAppInfo) {
-        fileAppInfo.seekg(0, std::ios::end);
-        size_t size = fileAppInfo.tellg();
-        fileAppInfo.seekg(0, std::ios::beg);
+bool FlutterApplicationDescription::Decoder::String(const char* str,
+                                                    rapidjson::SizeType length,
+                                                    bool copy) {
+  if (!Accept())
+    return Default();
+
+  switch (Top()) {
+    case kRoot:
+      switch (key_) {
+        case AppInfoKey::kId: desc_->id_.assign(str, length); break;
+        case AppInfoKey::kType: desc_->type_.assign(str, length); break;
+        case AppInfoKey::kTrustLevel: desc_->trust_level_.assign(str, length); break;
+        case AppInfoKey::kDefaultWindowType: default_window_type_.assign(str, length); break;
+        case AppInfoKey::kVersion: desc_->version_.assign(str, length); break;
+        case AppInfoKey::kIcon: desc_->icon_name_.assign(str, length); break;
+        case AppInfoKey::kFolderPath: desc_->folder_path_.assign(str, length); break;
+        case AppInfoKey::kTitle: desc_->title_.assign(str, length); break;
+        case AppInfoKey::kLocationHint: desc_->location_hint_.assign(str, length); break;
+        case AppInfoKey::kMain: desc_->main_path_.assign(str, length); break;
+        case AppInfoKey::kResolution:
+          has_resolution_ = true;
+          resolution_.assign(str, length);
+          break;
+        default: break;
+      }
+      break;
+    case kWindowGroup:
+      if (key_ == AppInfoKey::kName) {
+        has_group_name_ = true;
+        group_name_.assign(str, length);
+      }
+      break;
+    case kClientInfo:
+      if (key_ == AppInfoKey::kLayer) {
+        has_client_layer_ = true;
+        client_layer_.assign(str, length);
+      }
+      break;
+    case kLayerItem:
+      if (key_ == AppInfoKey::kName) {
+        has_layer_name_ = true;
+        layer_name_.assign(str, length);
+      }
+      break;
+    default:
+      break;
+  }
+  key_ = AppInfoKey::kUnknown;
+  return true;
+}
 
-        appInfo.resize(size);
-        fileAppInfo.read(&appInfo[0], size);
+bool FlutterApplicationDescription::Decoder::Key(const char* str,
+                                                 rapidjson::SizeType length,
+                                                 bool copy) {
+  if (skip_depth_)
+    return true;
 
-        if (appInfo.empty()) {
-          appInfo = "{}";
-        }
+  key_ = LookupKey(std::string_view(str, length));
+  if (Top() == kRoot && key_ != AppInfoKey::kUnknown) {
+    const uint64_t bit = 1ULL << static_cast<int>(key_);
+    if (seen_ & bit) {
+      key_ = AppInfoKey::kUnknown;
+    } else {
+      seen_ |= bit;
+      // Defined by the key alone, whatever its value.
+      if (key_ == AppInfoKey::kWindowGroup)
+        desc_->window_group_defined_ = true;
     }
-
-    return FlutterApplicationDescription::FromJsonString(appInfo.c_str());
+  }
+  return true;
 }
 
-std::unique_ptr<FlutterApplicationDescription> FlutterApplicationDescription::FromJsonString(
-    const char* json_str) {
+bool FlutterApplicationDescription::Decoder::StartObject() {
+  if (skip_depth_) {
+    skip_depth_++;
+    return true;
+  }
+  if (depth_ == 0) {
+    is_object_ = true;
+    Push(kRoot);
+    return true;
+  }
 
-  LOG_DEBUG("Parsing JSON-format: %s", json_str);
+  const Scope parent = Top();
+  const AppInfoKey key = key_;
+  key_ = AppInfoKey::kUnknown;
+  if (parent == kRoot && key == AppInfoKey::kAccessibility) {
+    Push(kAccessibility);
+  } else if (parent == kRoot && key == AppInfoKey::kClass) {
+    Push(kClass);
+  } else if (parent == kRoot && key == AppInfoKey::kWindowGroup) {
+    Push(kWindowGroup);
+  } else if (parent == kWindowGroup && key == AppInfoKey::kOwnerInfo) {
+    Push(kOwnerInfo);
+  } else if (parent == kWindowGroup && key == AppInfoKey::kClientInfo) {
+    Push(kClientInfo);
+  } else if (parent == kLayers) {
+    has_layer_name_ = has_z_ = false;
+    Push(kLayerItem);
+  } else if (parent == kKeyFilterTable) {
+    has_from_ = has_to_ = has_modifier_ = false;
+    Push(kKeyFilterItem);
+  } else {
+    skip_depth_ = 1;
+  }
+  return true;
+}
 
-  rapidjson::Document doc;
-  doc.Parse(json_str);
+bool FlutterApplicationDescription::Decoder::EndObject(
+    rapidjson::SizeType member_count) {
+  if (skip_depth_) {
+    skip_depth_--;
+    return true;
+  }
 
-  if (doc.HasParseError()) {
-    LOG_ERROR("Invalid JSON-format parse error: %s", json_str);
-    return nullptr;
+  if (Top() == kKeyFilterItem && has_from_ && has_to_ && has_modifier_) {
+    desc_->key_filter_table_[from_] = std::make_pair(to_, modifier_);
+  } else if (Top() == kLayerItem && has_layer_name_ && has_z_) {
+    owner_layers_.push_back({layer_name_, z_});
   }
+  depth_--;
+  key_ = AppInfoKey::kUnknown;
+  return true;
+}
 
-  if (!doc.IsObject()) {
-    LOG_ERROR("Invalid JSON-format parse error: %s", json_str);
-    return nullptr;
+bool FlutterApplicationDescription::Decoder::StartArray() {
+  if (skip_depth_) {
+    skip_depth_++;
+    return true;
   }
+  if (depth_ == 0)
+    return false;
 
-  auto app_desc =
-      std::unique_ptr<FlutterApplicationDescription>(new FlutterApplicationDescription());
+  const Scope parent = Top();
+  const AppInfoKey key = key_;
+  key_ = AppInfoKey::kUnknown;
+  if (parent == kRoot && key == AppInfoKey::kKeyFilterTable) {
+    Push(kKeyFilterTable);
+  } else if (parent == kOwnerInfo && key == AppInfoKey::kLayers) {
+    Push(kLayers);
+  } else {
+    skip_depth_ = 1;
+  }
+  return true;
+}
 
-  app_desc->id_ = (doc.FindMember("id") != doc.MemberEnd())? doc["id"].GetString() : std::string();
-  app_desc->type_ = (doc.FindMember("type") != doc.MemberEnd())? doc["type"].GetString() : std::string("flutter");
-  app_desc->transparency_ = (doc.FindMember("transparent") != doc.MemberEnd())? doc["transparent"].GetBool() : false;
-  app_desc->trust_level_ = (doc.FindMember("trustLevel") != doc.MemberEnd())? doc["trustLevel"].GetString() : std::string();
-  std::string default_window_type = (doc.FindMember("defaultWindowType") != doc.MemberEnd())? doc["defaultWindowType"].GetString() : std::string();
-  app_desc->default_window_type_ = WindowTypeFromString(default_window_type);
-  app_desc->native_lifecycle_interface_version_ = (doc.FindMember("nativeLifeCycleInterfaceVersion") != doc.MemberEnd())? doc["nativeLifeCycleInterfaceVersion"].GetInt() : 1;
-  app_desc->version_ = (doc.FindMember("version") != doc.MemberEnd())? doc["version"].GetString() : std::string();
-  app_desc->back_history_api_disabled_ = (doc.FindMember("disableBackHistoryAPI") != doc.MemberEnd())? doc["disableBackHistoryAPI"].GetBool(): false;
-  app_desc->icon_ = (doc.FindMember("icon") != doc.MemberEnd())? doc["icon"].GetString() : std::string();
-  app_desc->folder_path_ = (doc.FindMember("folderPath") != doc.MemberEnd())? doc["folderPath"].GetString() : std::string();
-  app_desc->title_ = (doc.FindMember("title") != doc.MemberEnd())? doc["title"].GetString() : std::string();
-  app_desc->handle_exit_key_ = (doc.FindMember("handleExitKey") != doc.MemberEnd())? doc["handleExitKey"].GetBool() : false;
-  app_desc->support_portrait_mode_ = (doc.FindMember("supportPortraitMode") != doc.MemberEnd())? doc["supportPortraitMode"].GetBool() : false;
-  app_desc->use_virtual_keyboard_ = (doc.FindMember("enableKeyboard") != doc.MemberEnd())? doc["enableKeyboard"].GetBool() : true;
-  app_desc->location_hint_ = (doc.FindMember("locationHint") != doc.MemberEnd())? doc["locationHint"].GetString() : std::string();
-  app_desc->handles_relaunch_ = (doc.FindMember("handlesRelaunch") != doc.MemberEnd())? doc["handlesRelaunch"].GetBool() : false;
-  app_desc->cloudgame_active_ = (doc.FindMember("cloudgame_active") != doc.MemberEnd())? doc["cloudgame_active"].GetBool() : false;
-
-  // Handle accessibility, supportsAudioGuidance
-  if (doc.FindMember("accessibility") != doc.MemberEnd()) {
-    rapidjson::Value& accessibility =  doc["accessibility"];
-    if (accessibility.IsObject()) {
-      if (accessibility.FindMember("supportsAudioGuidance") != accessibility.MemberEnd()) {
-        rapidjson::Value& audio_guidance = accessibility["supportsAudioGuidance"];
-        app_desc->supports_audio_guidance_ =
-          audio_guidance.IsBool() && audio_guidance.GetBool();
-      }
-    }
+bool FlutterApplicationDescription::Decoder::EndArray(
+    rapidjson::SizeType element_count) {
+  if (skip_depth_) {
+    skip_depth_--;
+    return true;
   }
+  depth_--;
+  key_ = AppInfoKey::kUnknown;
+  return true;
+}
+
+void FlutterApplicationDescription::Decoder::Finish() {
+  desc_->default_window_type_ = WindowTypeFromString(default_window_type_);
 
   // Handle resolution
-  if (doc.FindMember("resolution") != doc.MemberEnd()) {
-    rapidjson::Value& resolution = doc["resolution"];
-    if (resolution.IsString()) {
-      std::string override_resolution = doc["resolution"].GetString();
-      auto res_list = SplitString(override_resolution, 'x');
-      if (res_list.size() == 2) {
-        app_desc->width_override_ = std::stoi(res_list.at(0));
-        app_desc->height_override_ = std::stoi(res_list.at(1));
-      }
-      if (app_desc->width_override_ < 0 || app_desc->height_override_ < 0) {
-        app_desc->width_override_ = 0;
-        app_desc->height_override_ = 0;
+  if (has_resolution_) {
+    auto res_list = SplitString(resolution_, 'x');
+    if (res_list.size() == 2) {
+      try {
+        desc_->width_override_ = std::stoi(res_list.at(0));
+        desc_->height_override_ = std::stoi(res_list.at(1));
+      } catch (const std::exception& e) {
+        LOG_WARNING("Invalid resolution: %s", resolution_.c_str());
+        desc_->width_override_ = 0;
+        desc_->height_override_ = 0;
       }
     }
+    if (desc_->width_override_ < 0 || desc_->height_override_ < 0) {
+      desc_->width_override_ = 0;
+      desc_->height_override_ = 0;
+    }
   }
 
-  // Handle keyFilterTable
-  // Key code is changed only for facebooklogin WebApp
-  if (doc.FindMember("keyFilterTable") != doc.MemberEnd()) {
-    rapidjson::Value& key_filter_table = doc["keyFilterTable"];
-    if (key_filter_table.IsArray()) {
-      for (auto& k : key_filter_table.GetArray()) {
-        if (!k.IsObject())
-          continue;
-        int from = k["from"].GetInt();
-        int to = k["to"].GetInt();
-        int modifier = k["modifier"].GetInt();
-        app_desc->key_filter_table_[from] = std::make_pair(to, modifier);
-      }
-    }
+  // Handle windowGroup, whose name is only taken along with its owner flag.
+  if (has_group_name_ && has_group_owner_) {
+    desc_->window_group_name_ = group_name_;
+    desc_->window_group_owner_ = group_owner_;
+  }
+  if (desc_->window_group_owner_) {
+    desc_->window_group_allow_anon_ = allow_anonymous_;
+    for (const auto& layer : owner_layers_)
+      desc_->window_group_layers_[layer.first] = layer.second;
+  } else if (has_client_layer_) {
+    desc_->window_group_layers_[client_layer_] = 0;
   }
 
+  desc_->Resolve();
+}
+
+void FlutterApplicationDescription::Resolve() {
   // Handle trustLevel
-  if (!app_desc->CheckTrustLevel(app_desc->trust_level_))
-    app_desc->trust_level_ = std::string("default");
-
-  // Handle hidden property of window class
-  // Convert a json object for window class to an enum value
-  // and store it instead of the json object.
-  // The format of window class in the appinfo.json is as below.
-  //
-  // class : { "hidden" : boolean }
-  //
-  WindowClass class_value = kWindowClassNormal;
-  if (doc.FindMember("class") != doc.MemberEnd()) {
-    rapidjson::Value& clazz = doc["class"];
-    if (clazz.IsObject()) {
-      if (clazz["hidden"].IsBool() && clazz["hidden"].GetBool())
-        class_value = kWindowClassHidden;
+  if (!CheckTrustLevel(trust_level_))
+    trust_level_ = std::string("default");
+
+  // Handle bundlePath
+  icon_ = icon_name_;
+  if (!folder_path_.empty()) {
+    struct stat stat_ent_pt;
+    std::string temp_path = folder_path_ + "/" + icon_name_;
+    if (!stat(temp_path.c_str(), &stat_ent_pt)) {
+      icon_ = temp_path;
     }
   }
-  app_desc->window_class_value_ = class_value;
 
-  if (doc.FindMember("windowGroup") != doc.MemberEnd()) {
-    app_desc->window_group_defined_ = true;
-    rapidjson::Value& window_group_info = doc["windowGroup"];
+  is_privileged_ = id_.find("com.palm.") == 0
+      || id_.find("com.webos.") == 0
+      || id_.find("com.lge.") == 0;
+}
 
-    if (window_group_info.IsObject()) {
-      if (window_group_info.FindMember("name") != window_group_info.MemberEnd() &&
-          window_group_info.FindMember("owner") != window_group_info.MemberEnd())
-      {
-        app_desc->window_group_name_ = window_group_info["name"].GetString();
-        app_desc->window_group_owner_ = window_group_info["owner"].GetBool();
+template <typename Feed>
+std::unique_ptr<FlutterApplicationDescription> FlutterApplicationDescription::DecodeWith(
+    Feed feed) {
+  auto app_desc =
+      std::unique_ptr<FlutterApplicationDescription>(new FlutterApplicationDescription());
+  app_desc->type_ = "flutter";
+
+  Decoder decoder(app_desc.get());
+  if (!feed(decoder) || !decoder.IsObject())
+    return nullptr;
+
+  decoder.Finish();
+  return app_desc;
+}
+
+std::unique_ptr<FlutterApplicationDescription> FlutterApplicationDescription::DecodeInsitu(
+    char* json, JsonError* error) {
+  return DecodeWith([json, error](Decoder& decoder) {
+    rapidjson::InsituStringStream is(json);
+    return json_schema::Parse<rapidjson::kParseInsituFlag>(
+        json_schema::AppInfo(), is, decoder, error);
+  });
+}
+
+std::unique_ptr<FlutterApplicationDescription> FlutterApplicationDescription::Decode(
+    std::string_view json, JsonError* error) {
+  return DecodeWith([json, error](Decoder& decoder) {
+    rapidjson::MemoryStream is(json.data(), json.size());
+    return json_schema::Parse<rapidjson::kParseDefaultFlags>(
+        json_schema::AppInfo(), is, decoder, error);
+  });
+}
+
+std::unique_ptr<FlutterApplicationDescription> FlutterApplicationDescription::Decode(
+    const rapidjson::Value& json, JsonError* error) {
+  return DecodeWith([&json, error](Decoder& decoder) {
+    return json_schema::Accept(json_schema::AppInfo(), json, decoder, error);
+  });
+}
+
+std::unique_ptr<FlutterApplicationDescription> FlutterApplicationDescription::ParseAppInfo(
+    const std::string& pathAppInfo)
+{
+    int fd = open(pathAppInfo.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size <= 0) {
+      if (fd >= 0)
+        close(fd);
+      return FlutterApplicationDescription::FromJsonString("{}");
+    }
+
+    static const size_t kPageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t size = static_cast<size_t>(st.st_size);
+    std::unique_ptr<FlutterApplicationDescription> app_desc;
+    JsonError error;
+    bool parsed = false;
+
+    // Parse in place in a private mapping, whose zero-filled tail past the
+    // end of the file terminates the string. Files ending on a page
+    // boundary have no such tail and are read into a buffer instead.
+    if (size % kPageSize != 0) {
+      void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        LOG_DEBUG("Parsing JSON-format: %s", static_cast<const char*>(data));
+        app_desc = DecodeInsitu(static_cast<char*>(data), &error);
+        munmap(data, size);
+        parsed = true;
       }
-      app_desc->window_group_allow_anon_ = false;
-
-      if (app_desc->window_group_owner_) {
-        if (window_group_info.FindMember("ownerInfo") != window_group_info.MemberEnd()) {
-          rapidjson::Value& owner_info =  window_group_info["ownerInfo"];
-          if (owner_info.IsObject()) {
-            if (owner_info.FindMember("allowAnonymous") != owner_info.MemberEnd()) {
-              app_desc->window_group_allow_anon_ = owner_info["allowAnonymous"].GetBool();
-            }
-
-            if (owner_info.FindMember("layers") != owner_info.MemberEnd()) {
-              rapidjson::Value& layers =  owner_info["layers"];
-              if (layers.IsArray()) {
-                for (auto& layer : layers.GetArray()) {
-                  if (!layer.IsObject())
-                    continue;
-                  app_desc->window_group_layers_[layer["name"].GetString()] = layer["z"].GetInt();
-                }
-              }
-            }
-          }
-        }
-      } else {
-        if (window_group_info.FindMember("clientInfo") != window_group_info.MemberEnd()) {
-          rapidjson::Value& client_info =  window_group_info["clientInfo"];
-          if (client_info.FindMember("layer") != client_info.MemberEnd()) {
-            rapidjson::Value& layer =  client_info["layer"];
-            app_desc->window_group_layers_[layer.GetString()] = 0;
-          }
-        }
+    }
+    if (!parsed) {
+      std::string buffer(size, '\0');
+      if (pread(fd, &buffer[0], size, 0) != static_cast<ssize_t>(size)) {
+        close(fd);
+        return FlutterApplicationDescription::FromJsonString("{}");
       }
+      LOG_DEBUG("Parsing JSON-format: %s", buffer.c_str());
+      app_desc = DecodeInsitu(&buffer[0], &error);
     }
-  }
+    close(fd);
 
-  // Handle bundlePath
-  if (!app_desc->folder_path_.empty()) {
-    struct stat stat_ent_pt;
-    std::string temp_path = app_desc->folder_path_ + "/" + app_desc->icon_;
-    if (!stat(temp_path.c_str(), &stat_ent_pt)) {
-      app_desc->icon_ = temp_path;
+    if (!app_desc)
+      LOG_ERROR("Invalid %s, %s", pathAppInfo.c_str(), error.ToString().c_str());
+    return app_desc;
+}
+
+std::unique_ptr<FlutterApplicationDescription> FlutterApplicationDescription::FromAppInfo(
+    const char* bundlePath, const std::string& cache_dir)
+{
+  std::string pathAppInfo = std::string(bundlePath) + "/appinfo.json";
+  if (cache_dir.empty())
+    return ParseAppInfo(pathAppInfo);
+
+  const runner_cache::FileIdentity source = runner_cache::FileIdentity::Of(pathAppInfo);
+  char name[40];
+  snprintf(name, sizeof(name), "/appinfo-%016llx.bin",
+           static_cast<unsigned long long>(
+               runner_cache::Hash(pathAppInfo.data(), pathAppInfo.size())));
+  const std::string record_path = cache_dir + name;
+
+  std::string record;
+  if (source.Exists() && runner_cache::ReadPrivateFile(record_path, &record)) {
+    auto app_desc = Deserialize(record, source);
+    if (app_desc) {
+      g_cache_stats.hits++;
+      return app_desc;
     }
+    g_cache_stats.invalidations++;
+  } else {
+    g_cache_stats.misses++;
+  }
+
+  auto app_desc = ParseAppInfo(pathAppInfo);
+  if (app_desc && source.Exists()) {
+    app_desc->Serialize(source, &record);
+    if (!runner_cache::WriteFileAtomically(record_path, record.data(), record.size()))
+      LOG_WARNING("Failed to write app descriptor cache: %s", record_path.c_str());
+  }
+  return app_desc;
+}
+
+FlutterApplicationDescription::CacheStats FlutterApplicationDescription::GetCacheStats() {
+  return g_cache_stats;
+}
+
+void FlutterApplicationDescription::Serialize(const runner_cache::FileIdentity& source,
+                                              std::string* out) const {
+  RecordWriter writer(out);
+  out->assign(kRecordMagic, sizeof(kRecordMagic));
+  writer.U32(kRecordVersion);
+  writer.U64(source.dev);
+  writer.U64(source.ino);
+  writer.U64(static_cast<uint64_t>(source.mtime_ns));
+  writer.U64(static_cast<uint64_t>(source.size));
+
+  writer.String(id_);
+  writer.String(title_);
+  writer.String(icon_name_);
+  writer.String(type_);
+  writer.Bool(transparency_);
+  writer.I32(window_class_value_);
+  writer.String(trust_level_);
+  writer.String(folder_path_);
+  writer.String(default_window_type_);
+  writer.String(version_);
+  writer.I32(native_lifecycle_interface_version_);
+  writer.Bool(back_history_api_disabled_);
+  writer.I32(width_override_);
+  writer.I32(height_override_);
+  writer.U32(static_cast<uint32_t>(key_filter_table_.size()));
+  for (const auto& k : key_filter_table_) {
+    writer.I32(k.first);
+    writer.I32(k.second.first);
+    writer.I32(k.second.second);
+  }
+  writer.Bool(handle_exit_key_);
+  writer.Bool(support_portrait_mode_);
+  writer.Bool(supports_audio_guidance_);
+  writer.String(location_hint_);
+  writer.Bool(use_virtual_keyboard_);
+  writer.Bool(handles_relaunch_);
+  writer.Bool(window_group_defined_);
+  writer.String(window_group_name_);
+  writer.Bool(window_group_owner_);
+  writer.Bool(window_group_allow_anon_);
+  writer.U32(static_cast<uint32_t>(window_group_layers_.size()));
+  for (const auto& layer : window_group_layers_) {
+    writer.String(layer.first);
+    writer.I32(layer.second);
+  }
+  writer.Bool(cloudgame_active_);
+  writer.String(main_path_);
+}
+
+std::unique_ptr<FlutterApplicationDescription> FlutterApplicationDescription::Deserialize(
+    const std::string& data, const runner_cache::FileIdentity& source) {
+  if (data.size() < sizeof(kRecordMagic) ||
+      data.compare(0, sizeof(kRecordMagic), kRecordMagic, sizeof(kRecordMagic)) != 0)
+    return nullptr;
+
+  RecordReader reader(data, sizeof(kRecordMagic));
+  if (reader.U32() != kRecordVersion || reader.U64() != source.dev ||
+      reader.U64() != source.ino ||
+      reader.U64() != static_cast<uint64_t>(source.mtime_ns) ||
+      reader.U64() != static_cast<uint64_t>(source.size))
+    return nullptr;
+
+  auto app_desc =
+      std::unique_ptr<FlutterApplicationDescription>(new FlutterApplicationDescription());
+  app_desc->id_ = reader.String();
+  app_desc->title_ = reader.String();
+  app_desc->icon_name_ = reader.String();
+  app_desc->type_ = reader.String();
+  app_desc->transparency_ = reader.Bool();
+  app_desc->window_class_value_ =
+      reader.I32() == kWindowClassHidden ? kWindowClassHidden : kWindowClassNormal;
+  app_desc->trust_level_ = reader.String();
+  app_desc->folder_path_ = reader.String();
+  app_desc->default_window_type_ = reader.String();
+  app_desc->version_ = reader.String();
+  app_desc->native_lifecycle_interface_version_ = reader.I32();
+  app_desc->back_history_api_disabled_ = reader.Bool();
+  app_desc->width_override_ = reader.I32();
+  app_desc->height_override_ = reader.I32();
+  for (uint32_t count = reader.U32(); count > 0 && reader.Ok(); count--) {
+    int from = reader.I32();
+    int to = reader.I32();
+    app_desc->key_filter_table_[from] = std::make_pair(to, reader.I32());
   }
+  app_desc->handle_exit_key_ = reader.Bool();
+  app_desc->support_portrait_mode_ = reader.Bool();
+  app_desc->supports_audio_guidance_ = reader.Bool();
+  app_desc->location_hint_ = reader.String();
+  app_desc->use_virtual_keyboard_ = reader.Bool();
+  app_desc->handles_relaunch_ = reader.Bool();
+  app_desc->window_group_defined_ = reader.Bool();
+  app_desc->window_group_name_ = reader.String();
+  app_desc->window_group_owner_ = reader.Bool();
+  app_desc->window_group_allow_anon_ = reader.Bool();
+  for (uint32_t count = reader.U32(); count > 0 && reader.Ok(); count--) {
+    std::string name = reader.String();
+    app_desc->window_group_layers_[name] = reader.I32();
+  }
+  app_desc->cloudgame_active_ = reader.Bool();
+  app_desc->main_path_ = reader.String();
 
-  if (app_desc->id_.find("com.palm.") == 0
-      || app_desc->id_.find("com.webos.") == 0
-      || app_desc->id_.find("com.lge.") == 0 ) {
-    app_desc->is_privileged_ = true;
+  if (!reader.Ok() || !reader.AtEnd())
+    return nullptr;
+  app_desc->Resolve();
+  return app_desc;
+}
+
+std::unique_ptr<FlutterApplicationDescription> FlutterApplicationDescription::FromJsonString(
+    std::string_view json_str, JsonError* error) {
+
+  LOG_DEBUG("Parsing JSON-format: %.*s", static_cast<int>(json_str.size()),
+            json_str.data());
+
+  JsonError parse_error;
+  auto app_desc = Decode(json_str, &parse_error);
+  if (!app_desc) {
+    LOG_ERROR("Invalid app description, %s: %.*s",
+              parse_error.ToString().c_str(),
+              static_cast<int>(json_str.size()), json_str.data());
+    if (error)
+      *error = std::move(parse_error);
+    return nullptr;
   }
 
-  app_desc->main_path_ = (doc.FindMember("main") != doc.MemberEnd())? doc["main"].GetString() : std::string();
+  return app_desc;
+}
+
+std::unique_ptr<FlutterApplicationDescription> FlutterApplicationDescription::FromJsonValue(
+    const rapidjson::Value& json, JsonError* error) {
+  JsonError parse_error;
+  auto app_desc = Decode(json, &parse_error);
+  if (!app_desc) {
+    LOG_ERROR("Invalid app description, %s", parse_error.ToString().c_str());
+    if (error)
+      *error = std::move(parse_error);
+    return nullptr;
+  }
 
   return app_desc;
 }
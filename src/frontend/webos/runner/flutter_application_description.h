@@ -5,13 +5,23 @@
 #ifndef FLUTTER_APPLICATION_DESCRIPTION_H_
 #define FLUTTER_APPLICATION_DESCRIPTION_H_
 
+#include <cstdint>
 #include <memory>
 #include <set>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
+#include "rapidjson/fwd.h"
+
 typedef int32_t DisplayId;
 
+struct JsonError;
+
+namespace runner_cache {
+struct FileIdentity;
+}
+
 class FlutterApplicationDescription {
  public:
   enum WindowClass { kWindowClassNormal = 0x00, kWindowClassHidden = 0x01 };
@@ -37,11 +47,32 @@ class FlutterApplicationDescription {
 
   const std::string& Version() const { return version_; }
 
+  // With a |cache_dir|, the descriptor is loaded from a compiled record of
+  // appinfo.json kept there, as long as the file keeps its identity.
   static std::unique_ptr<FlutterApplicationDescription> FromAppInfo(
-      const char* bundlePath);
+      const char* bundlePath, const std::string& cache_dir = std::string());
 
+  // Returns nullptr, and fills |error| if given, when |json_str| is not
+  // valid JSON or does not match the appinfo schema. Parsing stops at the
+  // end of |json_str|, which need not be terminated.
   static std::unique_ptr<FlutterApplicationDescription> FromJsonString(
-      const char* json_str);
+      std::string_view json_str, JsonError* error = nullptr);
+  // Same for a description that is already parsed, e.g. by LaunchEnvelope.
+  static std::unique_ptr<FlutterApplicationDescription> FromJsonValue(
+      const rapidjson::Value& json, JsonError* error = nullptr);
+
+  // Versioned binary record of the descriptor compiled from |source|.
+  void Serialize(const runner_cache::FileIdentity& source, std::string* out) const;
+  // Returns nullptr if |data| is not a record of this version for |source|.
+  static std::unique_ptr<FlutterApplicationDescription> Deserialize(
+      const std::string& data, const runner_cache::FileIdentity& source);
+
+  struct CacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t invalidations;
+  };
+  static CacheStats GetCacheStats();
 
   int NativeLifeCycleInterfaceVersion() const { return native_lifecycle_interface_version_; }
 
@@ -87,11 +118,33 @@ class FlutterApplicationDescription {
   const std::string& MainPath() const { return main_path_; }
 
  private:
+  // Single-pass SAX decoder of appinfo.json, see the .cc file.
+  class Decoder;
+
+  // Parses |json| in place, modifying it.
+  static std::unique_ptr<FlutterApplicationDescription> DecodeInsitu(
+      char* json, JsonError* error);
+  static std::unique_ptr<FlutterApplicationDescription> Decode(
+      std::string_view json, JsonError* error);
+  static std::unique_ptr<FlutterApplicationDescription> Decode(
+      const rapidjson::Value& json, JsonError* error);
+  // Fills a new descriptor with the events |feed| sends to a Decoder.
+  template <typename Feed>
+  static std::unique_ptr<FlutterApplicationDescription> DecodeWith(Feed feed);
+  static std::unique_ptr<FlutterApplicationDescription> ParseAppInfo(
+      const std::string& path);
+
   bool CheckTrustLevel(std::string trust_level);
+  // Derives what is not taken verbatim from appinfo.json: the trust level
+  // falls back to "default", the icon is looked up in the folder and the
+  // privilege follows the id. Also run on cached records, which leave
+  // these out as they depend on more than appinfo.json.
+  void Resolve();
 
   std::string id_;
   std::string title_;
   std::string icon_;
+  std::string icon_name_;  // as given in appinfo.json
   std::string type_;
 
   bool transparency_;
@@ -1,13 +1,79 @@
 #include <memory.h>
+#include <mutex>
 #include <stdexcept>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <unordered_map>
+#include <vector>
 
 #include "flutter_embedder_loader.h"
+#include "runtime_path_resolver.h"
 #include "settings.h"
 
 using namespace flutter;
 
+namespace {
+
+// Resolves |Table| once per library handle. dlopen() of an already loaded
+// library returns the same handle, so later loaders get the cached table.
+template <typename Table>
+Table ResolveOnce(DynamicLoader& loader, Table (*resolve)(DynamicLoader&))
+{
+  static std::mutex mutex;
+  static std::unordered_map<void*, Table> cache;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = cache.find(loader.Handle());
+  if (it != cache.end())
+    return it->second;
+
+  Table table = resolve(loader);
+  cache.emplace(loader.Handle(), table);
+  return table;
+}
+
+EmbedderSymbols ResolveEmbedderSymbols(DynamicLoader& loader)
+{
+  EmbedderSymbols symbols;
+  symbols.createViewController =
+      reinterpret_cast<EmbedderSymbols::CreateViewControllerFunc>(
+          loader.TryLookup("WrapperCreateFlutterController"));
+  symbols.getDisplayFd = reinterpret_cast<EmbedderSymbols::GetDisplayFdFunc>(
+      loader.TryLookup("WrapperGetDisplayFd"));
+
+  const uint32_t* abiVersion =
+      static_cast<const uint32_t*>(loader.TryLookup("WrapperAbiVersion"));
+  if (abiVersion)
+    symbols.abiVersion = *abiVersion;
+
+  symbols.valid = true;
+  if (!symbols.createViewController) {
+    LOG_ERROR("Missing embedder symbol: WrapperCreateFlutterController");
+    symbols.valid = false;
+  }
+  if (symbols.abiVersion != EmbedderSymbols::kAbiVersion) {
+    LOG_ERROR("Embedder ABI version %u, expected %u", symbols.abiVersion,
+              EmbedderSymbols::kAbiVersion);
+    symbols.valid = false;
+  }
+  return symbols;
+}
+
+WebosInterfaceSymbols ResolveWebosInterfaceSymbols(DynamicLoader& loader)
+{
+  WebosInterfaceSymbols symbols;
+  symbols.registerPlugins =
+      reinterpret_cast<WebosInterfaceSymbols::RegisterPluginsFunc>(
+          loader.TryLookup("RegisterPlugins"));
+
+  symbols.valid = (symbols.registerPlugins != nullptr);
+  if (!symbols.valid)
+    LOG_ERROR("Missing plugin interface symbol: RegisterPlugins");
+  return symbols;
+}
+
+}  // namespace
+
 DynamicLoader::DynamicLoader(std::string filename, int flags)
   : m_fullPath(filename),
     m_flags(flags),
@@ -63,6 +129,18 @@ void* DynamicLoader::Lookup(const char* symbolStr)
   return targetFunc;
 }
 
+void* DynamicLoader::TryLookup(const char* symbolStr)
+{
+  if (nullptr == m_handle) return nullptr;
+
+  void *target = dlsym(m_handle, symbolStr);
+  if (nullptr == target)
+  {
+    dlerror();
+  }
+  return target;
+}
+
 void DynamicLoader::ThrowException(const char* errorStr)
 {
   char errorBuf[ERROR_BUF_SIZE];
@@ -74,99 +152,157 @@ void DynamicLoader::ThrowException(const char* errorStr)
 }
 
 EmbedderLoader::EmbedderLoader()
-    :DynamicLoader()
+    :EmbedderLoader(GetFlutterRuntimePath())
+{
+}
+
+EmbedderLoader::EmbedderLoader(const std::string& path, bool speculative)
+    :DynamicLoader(), m_path(path)
 {
     try {
-      std::string pathEmbedder = GetFlutterRuntimePath();
-      Open(pathEmbedder, RTLD_LAZY|RTLD_GLOBAL|RTLD_NODELETE);
+      if (speculative) {
+        // Not cached: the handle may be unloaded and its address reused.
+        Open(path, RTLD_LAZY|RTLD_LOCAL);
+        m_symbols = ResolveEmbedderSymbols(*this);
+      } else {
+        Open(path, RTLD_LAZY|RTLD_GLOBAL|RTLD_NODELETE);
+        m_symbols = ResolveOnce(*this, ResolveEmbedderSymbols);
+      }
     } catch (std::runtime_error& e) {
       LOG_ERROR("%s", e.what());
     }
 }
 
-std::string EmbedderLoader::GetFlutterRuntimePath()
+bool EmbedderLoader::Promote()
 {
-  Settings& settings = Settings::getInstance();
+  if (!IsLoaded()) return false;
+
+  // RTLD_NOLOAD only updates the flags of the already loaded object.
+  void* handle = dlopen(m_path.c_str(),
+                        RTLD_LAZY|RTLD_NOLOAD|RTLD_GLOBAL|RTLD_NODELETE);
+  if (handle == nullptr) {
+    LOG_ERROR("Failed to promote embedder %s: %s", m_path.c_str(), dlerror());
+    return false;
+  }
+  // Drop the extra reference; RTLD_NODELETE keeps the library resident.
+  dlclose(handle);
 
-  // TARGET_SUFFIX is defined in CMakeLists.txt
-  const std::string embedderName = "libflutter_elinux_" +
-                                    settings.getDisplayBackend() + ".so";
+  m_symbols = ResolveOnce(*this, ResolveEmbedderSymbols);
+  return true;
+}
 
-  std::string bundlePath = settings.getBundlePath() + "/lib/" + embedderName;
+const std::string& EmbedderLoader::GetFlutterRuntimePath()
+{
+  // Resolved again only when the settings changed since the last call.
+  static std::string path;
+  static uint64_t generation = UINT64_MAX;
 
-  if (access((bundlePath).c_str(), F_OK) == 0)
-    return bundlePath;
+  Settings& settings = Settings::getInstance();
+  if (generation != settings.generation()) {
+    path = ResolveRuntimePath(settings.get(settings_key::kAppId),
+                              settings.getBundlePath(),
+                              settings.getDisplayBackend(),
+                              settings.getRuntimeMode(),
+                              settings.getFrameworkVersion());
+    generation = settings.generation();
+  }
+  return path;
+}
 
+std::string EmbedderLoader::ResolveRuntimePath(const std::string& app_id,
+                                               const std::string& bundle_path,
+                                               const std::string& display_backend,
+                                               const std::string& runtimeMode,
+                                               const std::string& frameworkVersion)
+{
+  // TARGET_SUFFIX is defined in CMakeLists.txt
+  const std::string embedderName = "libflutter_elinux_" +
+                                    display_backend + ".so";
 
   const std::string runtimeBasePath = "/usr/lib/flutter/";
-  std::string runtimeMode = settings.getRuntimeMode();
-  std::string frameworkVersion = settings.getFrameworkVersion();
 
-  std::string systemPath = runtimeBasePath +
-                            frameworkVersion + "/" +
-                            runtimeMode + "/" +
-                            embedderName;
+  // The bundled embedder takes precedence over the system one.
+  const std::vector<std::string> candidates = {
+    bundle_path + "/lib/" + embedderName,
+    runtimeBasePath + frameworkVersion + "/" + runtimeMode + "/" + embedderName,
+  };
 
-  // TODO: check systemPath existency
-  return systemPath;
+  return RuntimePathResolver::Resolve(
+      app_id + "|" + frameworkVersion + "|" + runtimeMode + "|" + display_backend,
+      candidates);
 }
 
 FlutterViewController* EmbedderLoader::CreateViewController(
                                 const flutter::FlutterViewController::ViewProperties& view_properties,
                                 const DartProject& project)
 {
-  if (!IsLoaded()) return nullptr;
+  if (!IsValid()) return nullptr;
 
-  flutter::FlutterViewController* (*_CreateViewController)(
-            const FlutterViewController::ViewProperties& view_properties,
-            const DartProject& project) = nullptr;
-  try {
-    _CreateViewController = reinterpret_cast<FlutterViewController* (*)(
-                                const flutter::FlutterViewController::ViewProperties& view_properties,
-                                const flutter::DartProject& project)>
-                                    (Lookup("WrapperCreateFlutterController"));
-  } catch (std::runtime_error& e) {
-    LOG_ERROR("%s", e.what());
-  }
+  return m_symbols.createViewController(view_properties, project);
+}
 
-  if (!_CreateViewController) {
-    LOG_ERROR("empty _CreateViewController");
-    return nullptr;
+int EmbedderLoader::GetDisplayFd(flutter::FlutterViewController* controller)
+{
+  if (!IsValid() || !controller) return -1;
+
+  if (!m_symbols.getDisplayFd) {
+    LOG_INFO("Display fd is not exported by embedder");
+    return -1;
   }
 
-  return _CreateViewController(view_properties, project);
+  return m_symbols.getDisplayFd(controller);
 }
 
 WebosInterfaceLoader::WebosInterfaceLoader()
-    :DynamicLoader()
+    :WebosInterfaceLoader(GetInterfacePath(Settings::getInstance().getBundlePath()))
+{
+}
+
+WebosInterfaceLoader::WebosInterfaceLoader(const std::string& path,
+                                           bool speculative)
+    :DynamicLoader(), m_path(path)
 {
-  const std::string interfaceLib = "/lib/libwebos_plugin_interface.so";
-  Settings& settings = Settings::getInstance();
-  std::string bundlePath = settings.getBundlePath() + interfaceLib;
     try {
-      Open(bundlePath, RTLD_LAZY);
+      if (speculative) {
+        // Not cached: the handle may be unloaded and its address reused.
+        Open(path, RTLD_LAZY);
+        m_symbols = ResolveWebosInterfaceSymbols(*this);
+      } else {
+        // RTLD_NODELETE keeps the handle, and so the cached symbol table,
+        // valid after this loader is gone.
+        Open(path, RTLD_LAZY|RTLD_NODELETE);
+        m_symbols = ResolveOnce(*this, ResolveWebosInterfaceSymbols);
+      }
     } catch (std::runtime_error& e) {
       LOG_ERROR("%s", e.what());
     }
 }
 
-void WebosInterfaceLoader::RegisterPlugins(PluginRegistry* registry)
+bool WebosInterfaceLoader::Promote()
 {
-  if (!IsLoaded()) return;
-
-  void (*_RegisterPlugins)(flutter::PluginRegistry* registry) = nullptr;
+  if (!IsLoaded()) return false;
 
-  try {
-    _RegisterPlugins = reinterpret_cast<void (*)(PluginRegistry* registry)>
-                                    (Lookup("RegisterPlugins"));
-  } catch (std::runtime_error& e) {
-    LOG_ERROR("%s", e.what());
+  void* handle = dlopen(m_path.c_str(), RTLD_LAZY|RTLD_NOLOAD|RTLD_NODELETE);
+  if (handle == nullptr) {
+    LOG_ERROR("Failed to promote plugin interface %s: %s", m_path.c_str(),
+              dlerror());
+    return false;
   }
+  dlclose(handle);
 
-  if (!_RegisterPlugins) return;
-
-  _RegisterPlugins(registry);
+  m_symbols = ResolveOnce(*this, ResolveWebosInterfaceSymbols);
+  return true;
+}
 
-  return;
+std::string WebosInterfaceLoader::GetInterfacePath(const std::string& bundle_path)
+{
+  const std::string interfaceLib = "/lib/libwebos_plugin_interface.so";
+  return bundle_path + interfaceLib;
 }
 
+void WebosInterfaceLoader::RegisterPlugins(PluginRegistry* registry)
+{
+  if (!IsValid()) return;
+
+  m_symbols.registerPlugins(registry);
+}
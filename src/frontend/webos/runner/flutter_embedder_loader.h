@@ -4,6 +4,7 @@
 #include <flutter/dart_project.h>
 #include <flutter/flutter_view_controller.h>
 
+#include <cstdint>
 #include <string>
 #include <dlfcn.h>
 #include <stdexcept>
@@ -25,10 +26,13 @@ public:
   void Close();
 
   void* Lookup(const char* symbolStr);
+  // Same as Lookup(), but returns nullptr instead of throwing.
+  void* TryLookup(const char* symbolStr);
 
   void ThrowException(const char* errorStr);
 
   bool IsLoaded() { return (m_handle != nullptr); };
+  void* Handle() const { return m_handle; }
 private:
   std::string m_fullPath;
   int         m_flags;
@@ -36,23 +40,95 @@ private:
 
 };
 
+// Entry points of libflutter_elinux_<backend>.so, resolved in one pass
+// right after dlopen().
+struct EmbedderSymbols
+{
+  // Bumped on incompatible changes of the Wrapper* entry points. Embedders
+  // may export it as `const uint32_t WrapperAbiVersion`.
+  static constexpr uint32_t kAbiVersion = 1;
+
+  typedef flutter::FlutterViewController* (*CreateViewControllerFunc)(
+      const flutter::FlutterViewController::ViewProperties& view_properties,
+      const flutter::DartProject& project);
+  typedef int (*GetDisplayFdFunc)(flutter::FlutterViewController* controller);
+
+  CreateViewControllerFunc createViewController = nullptr;  // required
+  GetDisplayFdFunc getDisplayFd = nullptr;                  // optional
+  uint32_t abiVersion = kAbiVersion;
+  bool valid = false;
+};
+
+// Entry points of libwebos_plugin_interface.so.
+struct WebosInterfaceSymbols
+{
+  typedef void (*RegisterPluginsFunc)(flutter::PluginRegistry* registry);
+
+  RegisterPluginsFunc registerPlugins = nullptr;  // required
+  bool valid = false;
+};
+
 class EmbedderLoader : public DynamicLoader
 {
 public:
   EmbedderLoader();
+  // A speculative load is RTLD_LOCAL and fully unloaded on destruction, so
+  // a wrong guess leaves nothing behind. Promote() it before use.
+  explicit EmbedderLoader(const std::string& path, bool speculative = false);
+
+  // Reopens a speculative load RTLD_GLOBAL|RTLD_NODELETE, as a regular load
+  // would have opened it. Returns false when that fails.
+  bool Promote();
 
-  std::string GetFlutterRuntimePath();
+  // Path of the embedder for the current Settings.
+  static const std::string& GetFlutterRuntimePath();
+  static std::string ResolveRuntimePath(const std::string& app_id,
+                                        const std::string& bundle_path,
+                                        const std::string& display_backend,
+                                        const std::string& runtime_mode,
+                                        const std::string& framework_version);
   flutter::FlutterViewController* CreateViewController(
                                     const flutter::FlutterViewController::ViewProperties& view_properties,
                                     const flutter::DartProject& project);
+
+  // Returns the display connection fd of |controller|, or -1 when the
+  // embedder does not export WrapperGetDisplayFd.
+  int GetDisplayFd(flutter::FlutterViewController* controller);
+
+  // Symbols resolved at load time. Tables are cached per library handle,
+  // so loading the same embedder again (zygote children, relaunches)
+  // reuses them.
+  const EmbedderSymbols& Symbols() const { return m_symbols; }
+  bool IsValid() const { return m_symbols.valid; }
+
+private:
+  std::string m_path;
+  EmbedderSymbols m_symbols;
 };
 
 class WebosInterfaceLoader : public DynamicLoader
 {
 public:
   WebosInterfaceLoader();
+  // Same as for EmbedderLoader: a speculative load is unloaded again on
+  // destruction unless promoted.
+  explicit WebosInterfaceLoader(const std::string& path,
+                                bool speculative = false);
+
+  // Reopens a speculative load RTLD_NODELETE. Returns false when that
+  // fails.
+  bool Promote();
+
+  static std::string GetInterfacePath(const std::string& bundle_path);
 
   void RegisterPlugins(flutter::PluginRegistry* registry);
+
+  const WebosInterfaceSymbols& Symbols() const { return m_symbols; }
+  bool IsValid() const { return m_symbols.valid; }
+
+private:
+  std::string m_path;
+  WebosInterfaceSymbols m_symbols;
 };
 
 #endif  // _FLUTTER_DYNAMIC_LOADER_
@@ -9,48 +9,24 @@
 #include <flutter/flutter_view_controller.h>
 
 #include <limits.h>
+#include <iostream>
+#include <iterator>
 #include <string>
+#include <string_view>
 #include <unistd.h>
 
 #include "command_options.h"
+#include "launch_envelope.h"
 #include "logger.h"
 
 using namespace flutter;
 
 class FlutterEmbedderOptions {
  public:
-  FlutterEmbedderOptions() {
-    options_.AddString("display", "g",
-                       "Display backend [wayland|starfish|gbm|eglstream|x11]",
-                       "wayland", false);
-    options_.AddString("bundle", "b", "Path to Flutter project bundle",
-                       "", false);
-    options_.AddWithoutValue("cursor", "c", "show mouse cursor/pointer",
-                             false);
-    options_.AddInt("rotation", "r",
-                    "Window rotation(degree) [0(default)|90|180|270]", 0,
-                    false);
-    options_.AddDouble("force-scale-factor", "s",
-                       "Force a scale factor instead using default value", 1.0,
-                       false);
-
-    options_.AddString("title", "t", "Window title", "Flutter", false);
-    options_.AddWithoutValue("onscreen-keyboard", "k",
-                             "Enable on-screen keyboard", false);
-    options_.AddWithoutValue("window-decoration", "d",
-                             "Enable window decorations", false);
-    options_.AddWithoutValue("fullscreen", "f", "Always full-screen display",
-                             false);
-    options_.AddInt("width", "w", "Window width", 0, false);
-    options_.AddInt("height", "h", "Window height", 0, false);
-
-    options_.AddString("appId", "i", "set AppId", "com.webos.app.example.flutter", false);
-    options_.AddString("parameters", "p", "set launch params", "{}", false);
-    options_.AddString("appDesc", "a", "set Application Descriptions", "{}", false);
-    options_.AddString("preload", "l", "Use preload", "", false);
-    options_.AddString("keepAlive", "e", "keepAlive", "false", false);
-    options_.AddString("main", "m", "Redirect Path to Flutter project bundle", "", false);
-
+  FlutterEmbedderOptions() : options_(kOptions) {
+    options_.SetJsonArgumentParser([this](std::string_view json) {
+      return envelope_.Parse(json);
+    });
   }
 
   ~FlutterEmbedderOptions() = default;
@@ -73,12 +49,12 @@ class FlutterEmbedderOptions {
       return false;
     }
 
-    bundle_path_ = options_.GetValue<std::string>("bundle");
+    bundle_path_ = options_.GetString("bundle");
     if (bundle_path_.empty()) bundle_path_ = getExecutableDirectory();
 
     use_mouse_cursor_ = options_.Exist("cursor");
     if (options_.Exist("rotation")) {
-      switch (options_.GetValue<int>("rotation")) {
+      switch (options_.GetInt("rotation")) {
         case 90:
           window_view_rotation_ =
               flutter::FlutterViewController::ViewRotation::kRotation_90;
@@ -100,35 +76,35 @@ class FlutterEmbedderOptions {
 
     if (options_.Exist("force-scale-factor")) {
       is_force_scale_factor_ = true;
-      scale_factor_ = options_.GetValue<double>("force-scale-factor");
+      scale_factor_ = options_.GetDouble("force-scale-factor");
     } else {
       is_force_scale_factor_ = false;
       scale_factor_ = 1.0;
     }
 
-    display_backend_ = options_.GetValue<std::string>("display");
+    display_backend_ = options_.GetString("display");
 
     if (display_backend_ == "wayland")
     {
-      window_title_ = options_.GetValue<std::string>("title");
+      window_title_ = options_.GetString("title");
       use_onscreen_keyboard_ = options_.Exist("onscreen-keyboard");
       use_window_decoration_ = options_.Exist("window-decoration");
       window_view_mode_ =
           options_.Exist("fullscreen")
               ? flutter::FlutterViewController::ViewMode::kFullscreen
               : flutter::FlutterViewController::ViewMode::kNormal;
-      window_width_ = options_.GetValue<int>("width");
-      window_height_ = options_.GetValue<int>("height");
+      window_width_ = options_.GetInt("width");
+      window_height_ = options_.GetInt("height");
     } else if (display_backend_ == "x11") {
       use_onscreen_keyboard_ = false;
       use_window_decoration_ = false;
-      window_title_ = options_.GetValue<std::string>("title");
+      window_title_ = options_.GetString("title");
       window_view_mode_ =
           options_.Exist("fullscreen")
               ? flutter::FlutterViewController::ViewMode::kFullscreen
               : flutter::FlutterViewController::ViewMode::kNormal;
-      window_width_ = options_.GetValue<int>("width");
-      window_height_ = options_.GetValue<int>("height");
+      window_width_ = options_.GetInt("width");
+      window_height_ = options_.GetInt("height");
     } else {
       // gbm, eglstream, starfish
       use_onscreen_keyboard_ = false;
@@ -136,12 +112,14 @@ class FlutterEmbedderOptions {
       window_view_mode_ = flutter::FlutterViewController::ViewMode::kFullscreen;
     }
 
-    app_id_ = options_.GetValue<std::string>("appId");
-    params_ = options_.GetValue<std::string>("parameters");
-    app_desc_ = options_.GetValue<std::string>("appDesc");
-    preload_ = options_.GetValue<std::string>("preload");
-    keep_alive_ = options_.GetValue<std::string>("keepAlive");
-    redirect_path_ = options_.GetValue<std::string>("main");
+    app_id_ = options_.GetString("appId");
+    params_ = options_.GetString("parameters");
+    app_desc_ = options_.GetString("appDesc");
+    preload_ = options_.GetString("preload");
+    keep_alive_ = options_.GetString("keepAlive");
+    redirect_path_ = options_.GetString("main");
+    zygote_socket_ = options_.GetString("zygote");
+    zygote_launch_ = options_.GetString("zygote-launch");
 
     return true;
   }
@@ -163,15 +141,65 @@ class FlutterEmbedderOptions {
   double ScaleFactor() const { return scale_factor_; }
 
   std::string AppId() const { return app_id_; }
-  std::string Params() const { return params_; }
-  std::string AppDesc() const { return app_desc_; }
+  // Text of the launch parameters and app description, from argv or
+  // serialized from the launch request on first use.
+  std::string_view Params() const {
+    return ParamsJson() ? envelope_.ToString(*ParamsJson()) : params_;
+  }
+  std::string_view AppDesc() const {
+    return AppDescJson() ? envelope_.ToString(*AppDescJson()) : app_desc_;
+  }
+  // Parsed values when given as objects in a JSON-format launch request,
+  // else nullptr.
+  const rapidjson::Value* ParamsJson() const { return options_.GetJson("parameters"); }
+  const rapidjson::Value* AppDescJson() const { return options_.GetJson("appDesc"); }
   std::string DisplayBackend() const { return display_backend_; }
   bool IsPreload() const { return preload_.empty()? false : true; }
   bool IsKeepAlive() const {return keep_alive_ == "true"? true: false;}
   std::string RedirectPath() const { return redirect_path_; }
+  std::string ZygoteSocket() const { return zygote_socket_; }
+  std::string ZygoteLaunch() const { return zygote_launch_; }
 
  private:
-  commandline::CommandOptions options_;
+  static constexpr commandline::OptionSpec kOptionSpecs[] = {
+    commandline::StringOption("display", 'g',
+                              "Display backend [wayland|starfish|gbm|eglstream|x11]",
+                              "wayland", false),
+    commandline::StringOption("bundle", 'b', "Path to Flutter project bundle",
+                              "", false),
+    commandline::FlagOption("cursor", 'c', "show mouse cursor/pointer", false),
+    commandline::IntOption("rotation", 'r',
+                           "Window rotation(degree) [0(default)|90|180|270]", 0,
+                           false),
+    commandline::DoubleOption("force-scale-factor", 's',
+                              "Force a scale factor instead using default value", 1.0,
+                              false),
+
+    commandline::StringOption("title", 't', "Window title", "Flutter", false),
+    commandline::FlagOption("onscreen-keyboard", 'k',
+                            "Enable on-screen keyboard", false),
+    commandline::FlagOption("window-decoration", 'd',
+                            "Enable window decorations", false),
+    commandline::FlagOption("fullscreen", 'f', "Always full-screen display",
+                            false),
+    commandline::IntOption("width", 'w', "Window width", 0, false),
+    commandline::IntOption("height", 'h', "Window height", 0, false),
+
+    commandline::StringOption("appId", 'i', "set AppId", "com.webos.app.example.flutter", false),
+    commandline::StringOption("parameters", 'p', "set launch params", "{}", false),
+    commandline::StringOption("appDesc", 'a', "set Application Descriptions", "{}", false),
+    commandline::StringOption("preload", 'l', "Use preload", "", false),
+    commandline::StringOption("keepAlive", 'e', "keepAlive", "false", false),
+    commandline::StringOption("main", 'm', "Redirect Path to Flutter project bundle", "", false),
+    commandline::StringOption("zygote", 'z', "Run as zygote listening on the given socket", "", false),
+    commandline::StringOption("zygote-launch", 'y', "Launch through the zygote on the given socket", "", false),
+  };
+  static constexpr commandline::OptionTable<std::size(kOptionSpecs)> kOptions{kOptionSpecs};
+  static_assert(kOptions.IsValid(), "Duplicated command line option");
+
+  // Declared first, the parsed options refer into it.
+  LaunchEnvelope envelope_;
+  commandline::CommandOptions<std::size(kOptionSpecs)> options_;
 
   std::string bundle_path_;
   std::string window_title_;
@@ -187,12 +215,14 @@ class FlutterEmbedderOptions {
   bool is_force_scale_factor_ = false;
   double scale_factor_ = 1.0;
   std::string app_id_;
-  std::string params_;
-  std::string app_desc_;
+  std::string_view params_;
+  std::string_view app_desc_;
   std::string preload_;
   std::string keep_alive_;
   std::string display_backend_;
   std::string redirect_path_;
+  std::string zygote_socket_;
+  std::string zygote_launch_;
 };
 
 #endif  // FLUTTER_EMBEDDER_OPTIONS_
@@ -4,45 +4,130 @@
 
 #include "flutter_launch_params.h"
 
-#include <sys/stat.h>
-#include <sys/types.h>
-#include <unistd.h>
+#include <string_view>
 
-#include <iostream>
-#include <limits>
-#include <sstream>
-#include <vector>
+#include "rapidjson/memorystream.h"
 
-#include "rapidjson/document.h"
+#include "json_schema.h"
+#include "logger.h"
+
+// Fills the parameters from the SAX events of the top-level object. Value
+// types are checked by the schema validator before the events get here,
+// and the first of duplicated keys wins.
+class FlutterLaunchParams::Decoder
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, Decoder> {
+ public:
+  explicit Decoder(FlutterLaunchParams* params) : params_(params) {}
+
+  bool Default() {
+    key_ = kUnknown;
+    return true;
+  }
+  bool Bool(bool b) {
+    if (depth_ == 1 && key_ == kLaunchedHidden)
+      params_->launched_hidden_ = b;
+    return Default();
+  }
+  bool Int(int i) {
+    if (depth_ == 1 && key_ == kDisplayAffinity)
+      params_->display_affinity_ = i;
+    return Default();
+  }
+  // Non-negative numbers are reported as unsigned; the schema bounds them.
+  bool Uint(unsigned u) { return Int(static_cast<int>(u)); }
+  bool String(const char* str, rapidjson::SizeType length, bool copy) {
+    if (depth_ == 1 && key_ == kTarget)
+      params_->route_target_.assign(str, length);
+    else if (depth_ == 1 && key_ == kWindowType)
+      params_->window_type_.assign(str, length);
+    return Default();
+  }
+  bool Key(const char* str, rapidjson::SizeType length, bool copy) {
+    if (depth_ != 1)
+      return true;
+    std::string_view key(str, length);
+    if (key == "launchedHidden")
+      key_ = kLaunchedHidden;
+    else if (key == "displayAffinity")
+      key_ = kDisplayAffinity;
+    else if (key == "target")
+      key_ = kTarget;
+    else if (key == "windowType")
+      key_ = kWindowType;
+    else
+      key_ = kUnknown;
+    if (key_ != kUnknown) {
+      if (seen_ & (1u << key_))
+        key_ = kUnknown;
+      seen_ |= 1u << key_;
+    }
+    return true;
+  }
+  bool StartObject() {
+    depth_++;
+    return Default();
+  }
+  bool EndObject(rapidjson::SizeType member_count) {
+    depth_--;
+    return Default();
+  }
+  bool StartArray() {
+    depth_++;
+    return Default();
+  }
+  bool EndArray(rapidjson::SizeType element_count) {
+    depth_--;
+    return Default();
+  }
+
+ private:
+  enum Param { kUnknown, kLaunchedHidden, kDisplayAffinity, kTarget, kWindowType };
+
+  FlutterLaunchParams* params_;
+  int depth_ = 0;
+  Param key_ = kUnknown;
+  unsigned seen_ = 0;
+};
 
 FlutterLaunchParams::FlutterLaunchParams()
     : display_affinity_(0),
       launched_hidden_(false) {}
 
 std::unique_ptr<FlutterLaunchParams> FlutterLaunchParams::FromJsonString(
-    const char* json_str) {
-
-  std::cout << "Parsing JSON-format: " << json_str << std::endl;
-
-  rapidjson::Document doc;
-  doc.Parse(json_str);
+    std::string_view json_str, JsonError* error) {
 
-  if (doc.HasParseError()) {
-    std::cout << "Invalid JSON-format parse error: " << json_str << std::endl;
-    return nullptr;
-  }
+  LOG_DEBUG("Parsing JSON-format: %.*s", static_cast<int>(json_str.size()),
+            json_str.data());
 
-  if (!doc.IsObject()) {
-    std::cout << "Invalid JSON-format parse error: " << json_str << std::endl;
+  auto params =
+      std::unique_ptr<FlutterLaunchParams>(new FlutterLaunchParams());
+  Decoder decoder(params.get());
+  rapidjson::MemoryStream is(json_str.data(), json_str.size());
+  JsonError parse_error;
+  if (!json_schema::Parse<rapidjson::kParseDefaultFlags>(
+          json_schema::LaunchParams(), is, decoder, &parse_error)) {
+    LOG_ERROR("Invalid launch parameters, %s: %.*s",
+              parse_error.ToString().c_str(),
+              static_cast<int>(json_str.size()), json_str.data());
+    if (error)
+      *error = std::move(parse_error);
     return nullptr;
   }
+  return params;
+}
 
+std::unique_ptr<FlutterLaunchParams> FlutterLaunchParams::FromJsonValue(
+    const rapidjson::Value& json, JsonError* error) {
   auto params =
       std::unique_ptr<FlutterLaunchParams>(new FlutterLaunchParams());
-
-  params->launched_hidden_ =  (doc.FindMember("launchedHidden") != doc.MemberEnd())? doc["launchedHidden"].GetBool() : false;
-  params->display_affinity_ = (doc.FindMember("displayAffinity") != doc.MemberEnd())? doc["displayAffinity"].GetInt() : 0;
-  params->route_target_ = (doc.FindMember("target") != doc.MemberEnd())? doc["target"].GetString() : "";
-  params->window_type_ = (doc.FindMember("windowType") != doc.MemberEnd())? doc["windowType"].GetString() : "";
+  Decoder decoder(params.get());
+  JsonError parse_error;
+  if (!json_schema::Accept(json_schema::LaunchParams(), json, decoder,
+                           &parse_error)) {
+    LOG_ERROR("Invalid launch parameters, %s", parse_error.ToString().c_str());
+    if (error)
+      *error = std::move(parse_error);
+    return nullptr;
+  }
   return params;
 }
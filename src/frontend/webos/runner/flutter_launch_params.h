@@ -8,15 +8,26 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
+#include "rapidjson/fwd.h"
+
+struct JsonError;
+
 class FlutterLaunchParams {
  public:
   FlutterLaunchParams();
   virtual ~FlutterLaunchParams() {}
 
+  // Returns nullptr, and fills |error| if given, when |json_str| is not
+  // valid JSON or does not match the launch parameter schema. Parsing
+  // stops at the end of |json_str|, which need not be terminated.
   static std::unique_ptr<FlutterLaunchParams> FromJsonString(
-      const char* json_str);
+      std::string_view json_str, JsonError* error = nullptr);
+  // Same for parameters that are already parsed, e.g. by LaunchEnvelope.
+  static std::unique_ptr<FlutterLaunchParams> FromJsonValue(
+      const rapidjson::Value& json, JsonError* error = nullptr);
 
   int GetDisplayAffinity() { return display_affinity_; }
   bool IsLaunchedHidden() { return launched_hidden_; }
@@ -24,6 +35,8 @@ class FlutterLaunchParams {
   std::string GetWindowType() { return window_type_; }
 
  private:
+  class Decoder;
+
   int display_affinity_;
   bool launched_hidden_;
   std::string route_target_;
@@ -5,16 +5,33 @@
 
 #include "flutter_window.h"
 
+#include "event_loop.h"
 #include "logger.h"
+#include "loop_telemetry.h"
+#include "page_prefetcher.h"
+#include "settings.h"
+#include "startup_orchestrator.h"
+#include "startup_tracer.h"
 
 #include <chrono>
 #include <cmath>
 #include <dlfcn.h>
 #include <iostream>
 #include <thread>
+#include <unistd.h>
 
 using namespace flutter;
 
+namespace {
+
+// Tasks posted to the platform runner from other threads are only picked
+// up when the loop wakes, and the engine has no hook to wake it. Hidden
+// windows still tick at this rate so platform channel replies, plugin
+// callbacks and relaunches are handled while no window event arrives.
+constexpr auto kBackgroundTick = std::chrono::seconds(1);
+
+}  // namespace
+
 FlutterWindow::FlutterWindow(
     const flutter::FlutterViewController::ViewProperties view_properties,
     const flutter::DartProject project)
@@ -22,9 +39,26 @@ FlutterWindow::FlutterWindow(
 
 bool FlutterWindow::OnCreate(std::shared_ptr<FlutterApplicationDescription>appDesc) {
 
-  embedder_ = std::make_unique<EmbedderLoader>();
+  StartupOrchestrator& orchestrator = StartupOrchestrator::getInstance();
+  embedder_ = orchestrator.TakeEmbedder(EmbedderLoader::GetFlutterRuntimePath());
+  if (!embedder_) {
+    TRACE_STARTUP_SCOPE("EmbedderLoader");
+    embedder_ = std::make_unique<EmbedderLoader>();
+  }
+
+  // Missing entry points are reported at load time; bail out before any
+  // window work.
+  if (!embedder_->IsValid()) {
+    LOG_ERROR("Embedder is not usable: %s",
+              EmbedderLoader::GetFlutterRuntimePath().c_str());
+    return false;
+  }
 
-  flutter::FlutterViewController* vc = embedder_->CreateViewController(view_properties_, project_);
+  flutter::FlutterViewController* vc = nullptr;
+  {
+    TRACE_STARTUP_SCOPE("CreateViewController");
+    vc = embedder_->CreateViewController(view_properties_, project_);
+  }
 
   flutter_view_controller_ = std::unique_ptr<flutter::FlutterViewController>(vc);
 
@@ -39,8 +73,16 @@ bool FlutterWindow::OnCreate(std::shared_ptr<FlutterApplicationDescription>appDe
     LOG_DEBUG("id: %s", appDesc->Id().c_str());
 
     // Register Flutter plugins.
-    webos_plugin_interface_ = std::make_unique<WebosInterfaceLoader>();
-    webos_plugin_interface_->RegisterPlugins(flutter_view_controller_->engine());
+    {
+      TRACE_STARTUP_SCOPE("RegisterPlugins");
+      webos_plugin_interface_ = orchestrator.TakePluginInterface(
+          WebosInterfaceLoader::GetInterfacePath(
+              Settings::getInstance().getBundlePath()));
+      if (!webos_plugin_interface_) {
+        webos_plugin_interface_ = std::make_unique<WebosInterfaceLoader>();
+      }
+      webos_plugin_interface_->RegisterPlugins(flutter_view_controller_->engine());
+    }
 
 
     flutter::FlutterView* view = flutter_view_controller_->view();
@@ -75,6 +117,178 @@ void FlutterWindow::OnDestroy() {
 }
 
 void FlutterWindow::Run() {
+  EventLoop loop;
+  if (!loop.Init()) {
+    LOG_WARNING("Event loop is unavailable, falling back to polling");
+    RunPolling();
+    return;
+  }
+
+  // Without the display fd, window events are only picked up on the
+  // frame-rate ticks below.
+  const int display_fd =
+      embedder_->GetDisplayFd(flutter_view_controller_.get());
+  const bool watch_display = display_fd >= 0 && loop.AddWatch(display_fd);
+
+  // Hidden or preloaded windows replace the idle frame tick with the slow
+  // kBackgroundTick, besides engine tasks and window events. The show event
+  // arrives on the display fd, so without it we cannot tell when to resume
+  // and keep the cadence.
+  bool background = view_properties_.launched_hidden && watch_display;
+  if (view_properties_.launched_hidden && !watch_display) {
+    LOG_INFO("Background mode needs the display fd, keeping frame cadence");
+  }
+
+  Settings& settings = Settings::getInstance();
+
+  // Opt-in: place idle wakeups on the estimated vsync timeline.
+  vsync_pacing_ = settings.get<std::string_view>(settings_key::kFramePacing) == kFramePacingVsync;
+  bool on_boundary = false;
+  uint64_t settings_generation = settings.generation();
+
+  // Opt-out: the per-iteration telemetry is cheap enough to stay on.
+  if (settings.get<std::string_view>(settings_key::kLoopTelemetry) != "false") {
+    telemetry_ = std::make_unique<LoopTelemetry>();
+    LoopTelemetry::InstallSignalHandler(loop.wake_fd());
+  }
+
+  // Main loop.
+  auto next_flutter_event_time = std::chrono::steady_clock::now();
+  auto iteration_start = next_flutter_event_time;
+  auto first_dispatch = StartupTracer::Now();
+  while (flutter_view_controller_->view()->DispatchEvent()) {
+    auto dispatched = std::chrono::steady_clock::now();
+    if (first_dispatch.ts_us) {
+      StartupTracer& tracer = StartupTracer::getInstance();
+      tracer.AddPhase("FirstDispatchEvent", first_dispatch, StartupTracer::Now());
+      PagePrefetcher::getInstance().RecordProfile();
+      tracer.Flush();
+      first_dispatch.ts_us = 0;
+    }
+
+    // Wait until the next event, or until the display has input for us.
+    int reason = loop.WaitUntil(next_flutter_event_time);
+    auto woken = std::chrono::steady_clock::now();
+    if (background && (reason & EventLoop::kWakeReadable)) {
+      LOG_INFO("Window event while hidden, resuming frame pacing");
+      background = false;
+    }
+    if (vsync_pacing_) {
+      if (reason & EventLoop::kWakeReadable) {
+        frame_pacer_.OnFrameObserved(woken);
+      }
+      if (on_boundary && (reason & EventLoop::kWakeTimeout)) {
+        frame_pacer_.OnWakeup(next_flutter_event_time, woken);
+      }
+    }
+
+    // Processes any pending events in the Flutter engine, and returns the
+    // number of nanoseconds until the next scheduled event (or max, if none).
+    auto wait_duration = flutter_view_controller_->engine()->ProcessMessages();
+    auto now = std::chrono::steady_clock::now();
+
+    if (telemetry_) {
+      const bool late = (reason & EventLoop::kWakeTimeout) &&
+                        woken > next_flutter_event_time;
+      telemetry_->Record({
+          static_cast<uint64_t>((dispatched - iteration_start).count()),
+          static_cast<uint64_t>((woken - dispatched).count()),
+          late ? static_cast<uint64_t>(
+                     (woken - next_flutter_event_time).count())
+               : 0,
+          static_cast<uint64_t>((now - woken).count()),
+      });
+      if (LoopTelemetry::ConsumeDumpRequest()) {
+        DumpTelemetry();
+      }
+    }
+
+    // Frame pacing can be switched by a settings hot reload.
+    if (settings.generation() != settings_generation) {
+      settings_generation = settings.generation();
+      vsync_pacing_ = settings.get<std::string_view>(settings_key::kFramePacing) ==
+                      kFramePacingVsync;
+    }
+
+    on_boundary = false;
+    if (wait_duration != std::chrono::nanoseconds::max()) {
+      next_flutter_event_time = now + wait_duration;
+    } else if (background) {
+      // Sleep until a window event, an engine task or the background tick.
+      next_flutter_event_time = now + kBackgroundTick;
+    } else if (vsync_pacing_) {
+      // Wait for the next vsync boundary if no events.
+      frame_pacer_.SetNominalPeriod(FrameInterval(), now);
+      next_flutter_event_time = frame_pacer_.NextBoundary(now);
+      on_boundary = true;
+    } else {
+      // Wait for the next frame if no events.
+      next_flutter_event_time = now + FrameInterval();
+    }
+    iteration_start = now;
+  }
+
+  if (vsync_pacing_) {
+    LOG_INFO("Frame pacing: period %lld ns, drift %lld ns, missed %llu",
+             static_cast<long long>(frame_pacer_.Period().count()),
+             static_cast<long long>(frame_pacer_.DriftNs()),
+             static_cast<unsigned long long>(frame_pacer_.MissedDeadlines()));
+  }
+  if (telemetry_) {
+    // |loop| closes its eventfd on return; keep the handler off the number.
+    LoopTelemetry::InstallSignalHandler(-1);
+    DumpTelemetry();
+  }
+}
+
+void FlutterWindow::DumpTelemetry() {
+  Settings& settings = Settings::getInstance();
+  std::string log_path = settings.get(settings_key::kAppLogPath);
+  if (log_path.empty()) {
+    log_path = "/tmp";
+  }
+  std::string app_id = settings.get(settings_key::kAppId);
+  std::string file_path = log_path + "/" +
+                          (app_id.empty() ? std::string("flutter") : app_id) +
+                          ".loop-telemetry.log";
+
+  FILE* fp = fopen(file_path.c_str(), "a");
+  if (fp == NULL) {
+    LOG_WARNING("Failed to open telemetry file: %s", file_path.c_str());
+    return;
+  }
+
+  fprintf(fp, "# pid %d, uptime %lld ms\n", static_cast<int>(getpid()),
+          static_cast<long long>(
+              std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::steady_clock::now().time_since_epoch())
+                  .count()));
+  telemetry_->Dump(fp);
+  if (vsync_pacing_) {
+    fprintf(fp, "# frame pacing: period=%lld drift=%lld period_drift=%lld "
+                "missed=%llu rejected=%llu\n",
+            static_cast<long long>(frame_pacer_.Period().count()),
+            static_cast<long long>(frame_pacer_.DriftNs()),
+            static_cast<long long>(frame_pacer_.PeriodDriftNs()),
+            static_cast<unsigned long long>(frame_pacer_.MissedDeadlines()),
+            static_cast<unsigned long long>(
+                frame_pacer_.RejectedObservations()));
+  }
+  fclose(fp);
+  LOG_INFO("Loop telemetry written to %s", file_path.c_str());
+}
+
+std::chrono::nanoseconds FlutterWindow::FrameInterval() {
+  // GetFrameRate() reports the refresh rate in mHz.
+  auto frame_rate = flutter_view_controller_->view()->GetFrameRate();
+  if (frame_rate <= 0) {
+    frame_rate = kDefaultFrameRate;
+  }
+  return std::chrono::nanoseconds(
+      static_cast<int64_t>(1000000000000.0 / frame_rate));
+}
+
+void FlutterWindow::RunPolling() {
   // Main loop.
   auto next_flutter_event_time =
       std::chrono::steady_clock::time_point::clock::now();
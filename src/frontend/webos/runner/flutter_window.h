@@ -10,7 +10,10 @@
 #include <flutter/flutter_view_controller.h>
 #include "flutter_application_description.h"
 #include "flutter_embedder_loader.h"
+#include "frame_pacer.h"
+#include "loop_telemetry.h"
 
+#include <chrono>
 #include <memory>
 
 class FlutterWindow {
@@ -28,12 +31,27 @@ class FlutterWindow {
   void OnDestroy();
   void Run();
 
+  // Vsync timeline and its drift/missed-deadline counters.
+  const FramePacer& GetFramePacer() const { return frame_pacer_; }
+
  private:
+  // 60Hz in mHz, used when the view does not report a refresh rate.
+  static constexpr int32_t kDefaultFrameRate = 60000;
+
+  // Legacy sleep-based loop, used when epoll/timerfd are unavailable.
+  void RunPolling();
+  std::chrono::nanoseconds FrameInterval();
+  // Appends the loop telemetry to FLUTTER_APP_LOG_PATH.
+  void DumpTelemetry();
+
   flutter::FlutterViewController::ViewProperties view_properties_;
   flutter::DartProject project_;
   std::unique_ptr<flutter::FlutterViewController> flutter_view_controller_;
   std::unique_ptr<WebosInterfaceLoader> webos_plugin_interface_;
   std::unique_ptr<EmbedderLoader> embedder_;
+  FramePacer frame_pacer_;
+  bool vsync_pacing_ = false;
+  std::unique_ptr<LoopTelemetry> telemetry_;
 };
 
 #endif  // FLUTTER_WINDOW_
@@ -0,0 +1,98 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "frame_pacer.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+// Floor division for signed nanosecond counts.
+int64_t FloorDiv(int64_t a, int64_t b) {
+  int64_t q = a / b;
+  if ((a % b != 0) && ((a < 0) != (b < 0)))
+    q--;
+  return q;
+}
+
+}  // namespace
+
+void FramePacer::SetNominalPeriod(std::chrono::nanoseconds period,
+                                  Clock::time_point now) {
+  if (period.count() <= 0)
+    return;
+
+  // Ignore jitter in the reported refresh rate below 1%.
+  if (nominal_period_.count() > 0 &&
+      std::llabs((period - nominal_period_).count()) * 100 <
+          nominal_period_.count())
+    return;
+
+  nominal_period_ = period;
+  period_ = period;
+  phase_ = now;
+  accepted_observations_ = 0;
+  consecutive_rejections_ = 0;
+}
+
+void FramePacer::OnFrameObserved(Clock::time_point timestamp) {
+  const int64_t period = period_.count();
+  if (period <= 0)
+    return;
+
+  // Distance to the nearest boundary of the current timeline.
+  const int64_t delta = (timestamp - phase_).count();
+  const int64_t frames = FloorDiv(delta + period / 2, period);
+  const int64_t error = delta - frames * period;
+
+  // Once locked, anything far from a boundary is an input event rather
+  // than a frame callback and would only pull the phase off.
+  if (accepted_observations_ >= kLockObservations &&
+      std::llabs(error) > period / 4) {
+    rejected_observations_++;
+    if (++consecutive_rejections_ < kRelockRejections)
+      return;
+    // Input events are sporadic; a run of misses means the display moved.
+    // Re-anchor on this observation and rebuild the lock from scratch.
+    phase_ = timestamp;
+    accepted_observations_ = 0;
+    consecutive_rejections_ = 0;
+    return;
+  }
+  consecutive_rejections_ = 0;
+
+  // Second order loop: the phase follows 1/8 of the error, the period
+  // follows the error spread over the frames since the last anchor.
+  phase_ += std::chrono::nanoseconds(frames * period + error / 8);
+  if (frames > 0) {
+    const int64_t nominal = nominal_period_.count();
+    const int64_t corrected = period + error / (16 * frames);
+    period_ = std::chrono::nanoseconds(
+        std::clamp(corrected, nominal - nominal / 10, nominal + nominal / 10));
+  }
+
+  drift_ns_ += (std::llabs(error) - drift_ns_) / 8;
+  accepted_observations_++;
+}
+
+FramePacer::Clock::time_point FramePacer::NextBoundary(
+    Clock::time_point now) const {
+  const int64_t period = period_.count();
+  if (period <= 0)
+    return now;
+
+  const int64_t frames = FloorDiv((now - phase_).count(), period) + 1;
+  return phase_ + std::chrono::nanoseconds(frames * period);
+}
+
+void FramePacer::OnWakeup(Clock::time_point deadline,
+                          Clock::time_point actual) {
+  const int64_t period = period_.count();
+  if (period <= 0 || actual <= deadline)
+    return;
+
+  // Every boundary passed while we were still asleep is a missed frame.
+  missed_deadlines_ += (actual - deadline).count() / period;
+}
@@ -0,0 +1,63 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_RUNNER_FRAME_PACER_H_
+#define FLUTTER_RUNNER_FRAME_PACER_H_
+
+#include <chrono>
+#include <cstdint>
+
+// Phase-locked vsync timeline for the runner main loop.
+//
+// Instead of scheduling idle wakeups at now + period, which drifts against
+// the display refresh, the pacer keeps an estimate of the vsync period and
+// phase and places wakeups on the next boundary of that timeline. The
+// estimate is corrected from observed frame timestamps (display events).
+class FramePacer {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  FramePacer() = default;
+  ~FramePacer() = default;
+
+  // (Re)anchors the timeline when the nominal period changes noticeably,
+  // e.g. on a refresh rate switch.
+  void SetNominalPeriod(std::chrono::nanoseconds period, Clock::time_point now);
+
+  // Feeds an observed frame timestamp into the phase/period estimate.
+  void OnFrameObserved(Clock::time_point timestamp);
+
+  // Returns the first vsync boundary strictly after |now|.
+  Clock::time_point NextBoundary(Clock::time_point now) const;
+
+  // Accounts a wakeup that was scheduled on a boundary.
+  void OnWakeup(Clock::time_point deadline, Clock::time_point actual);
+
+  std::chrono::nanoseconds Period() const { return period_; }
+  // Filtered absolute phase error between observations and the timeline.
+  int64_t DriftNs() const { return drift_ns_; }
+  // Difference between the estimated and the nominal period.
+  int64_t PeriodDriftNs() const { return (period_ - nominal_period_).count(); }
+  uint64_t MissedDeadlines() const { return missed_deadlines_; }
+  uint64_t RejectedObservations() const { return rejected_observations_; }
+
+ private:
+  // Observations accepted before outlier rejection kicks in.
+  static constexpr uint32_t kLockObservations = 8;
+  // Consecutive rejections after which the lock is assumed lost, e.g. after
+  // a phase step on mode switch, and the timeline is re-anchored.
+  static constexpr uint32_t kRelockRejections = 8;
+
+  std::chrono::nanoseconds nominal_period_{0};
+  std::chrono::nanoseconds period_{0};
+  Clock::time_point phase_;
+  uint32_t accepted_observations_ = 0;
+  uint32_t consecutive_rejections_ = 0;
+
+  int64_t drift_ns_ = 0;
+  uint64_t missed_deadlines_ = 0;
+  uint64_t rejected_observations_ = 0;
+};
+
+#endif  // FLUTTER_RUNNER_FRAME_PACER_H_
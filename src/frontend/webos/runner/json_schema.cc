@@ -0,0 +1,164 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "json_schema.h"
+
+#include <memory>
+
+#include "rapidjson/document.h"
+#include "rapidjson/error/en.h"
+
+#include "logger.h"
+
+namespace {
+
+// Launch parameters carry arbitrary app-defined keys next to the ones the
+// runner reads, so only those are constrained.
+constexpr char kLaunchParamsSchema[] = R"({
+  "type": "object",
+  "properties": {
+    "launchedHidden": { "type": "boolean" },
+    "displayAffinity": { "$ref": "#/definitions/int32" },
+    "target": { "type": "string" },
+    "windowType": { "type": "string" }
+  },
+  "definitions": {
+    "int32": { "type": "integer", "minimum": -2147483648, "maximum": 2147483647 }
+  }
+})";
+
+// The appinfo.json keys read by FlutterApplicationDescription. Keys used
+// by other components are left alone.
+constexpr char kAppInfoSchema[] = R"({
+  "type": "object",
+  "properties": {
+    "id": { "type": "string" },
+    "type": { "type": "string" },
+    "transparent": { "type": "boolean" },
+    "trustLevel": { "type": "string" },
+    "defaultWindowType": { "type": "string" },
+    "nativeLifeCycleInterfaceVersion": { "$ref": "#/definitions/int32" },
+    "version": { "type": "string" },
+    "disableBackHistoryAPI": { "type": "boolean" },
+    "icon": { "type": "string" },
+    "folderPath": { "type": "string" },
+    "title": { "type": "string" },
+    "handleExitKey": { "type": "boolean" },
+    "supportPortraitMode": { "type": "boolean" },
+    "enableKeyboard": { "type": "boolean" },
+    "locationHint": { "type": "string" },
+    "handlesRelaunch": { "type": "boolean" },
+    "cloudgame_active": { "type": "boolean" },
+    "main": { "type": "string" },
+    "resolution": { "type": "string" },
+    "accessibility": {
+      "type": "object",
+      "properties": {
+        "supportsAudioGuidance": { "type": "boolean" }
+      }
+    },
+    "class": {
+      "type": "object",
+      "properties": {
+        "hidden": { "type": "boolean" }
+      }
+    },
+    "keyFilterTable": {
+      "type": "array",
+      "items": {
+        "type": "object",
+        "required": [ "from", "to", "modifier" ],
+        "properties": {
+          "from": { "$ref": "#/definitions/int32" },
+          "to": { "$ref": "#/definitions/int32" },
+          "modifier": { "$ref": "#/definitions/int32" }
+        }
+      }
+    },
+    "windowGroup": {
+      "type": "object",
+      "properties": {
+        "name": { "type": "string" },
+        "owner": { "type": "boolean" },
+        "ownerInfo": {
+          "type": "object",
+          "properties": {
+            "allowAnonymous": { "type": "boolean" },
+            "layers": {
+              "type": "array",
+              "items": {
+                "type": "object",
+                "required": [ "name", "z" ],
+                "properties": {
+                  "name": { "type": "string" },
+                  "z": { "$ref": "#/definitions/int32" }
+                }
+              }
+            }
+          }
+        },
+        "clientInfo": {
+          "type": "object",
+          "properties": {
+            "layer": { "type": "string" }
+          }
+        }
+      }
+    }
+  },
+  "definitions": {
+    "int32": { "type": "integer", "minimum": -2147483648, "maximum": 2147483647 }
+  }
+})";
+
+// The schema document refers into the parsed source, so both are kept.
+class CompiledSchema {
+ public:
+  explicit CompiledSchema(const char* json) {
+    document_.Parse(json);
+    if (document_.HasParseError()) {
+      // Only reachable by editing the schemas above.
+      LOG_ERROR("Invalid built-in schema: %s",
+                rapidjson::GetParseError_En(document_.GetParseError()));
+      document_.SetObject();
+    }
+    schema_.reset(new rapidjson::SchemaDocument(document_));
+  }
+
+  const rapidjson::SchemaDocument& Get() const { return *schema_; }
+
+ private:
+  rapidjson::Document document_;
+  std::unique_ptr<rapidjson::SchemaDocument> schema_;
+};
+
+}  // namespace
+
+std::string JsonError::ToString() const {
+  switch (code) {
+    case Code::kNone:
+      return "no error";
+    case Code::kParse:
+      return std::string(rapidjson::GetParseError_En(parse_error)) +
+             " (offset " + std::to_string(offset) + ")";
+    case Code::kSchema:
+      return "'" + (pointer.empty() ? std::string("/") : pointer) +
+             "' fails schema keyword '" + keyword + "'";
+  }
+  return std::string();
+}
+
+namespace json_schema {
+
+const rapidjson::SchemaDocument& LaunchParams() {
+  static const CompiledSchema schema(kLaunchParamsSchema);
+  return schema.Get();
+}
+
+const rapidjson::SchemaDocument& AppInfo() {
+  static const CompiledSchema schema(kAppInfoSchema);
+  return schema.Get();
+}
+
+}  // namespace json_schema
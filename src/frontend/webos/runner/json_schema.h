@@ -0,0 +1,113 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_RUNNER_JSON_SCHEMA_H_
+#define FLUTTER_RUNNER_JSON_SCHEMA_H_
+
+#include <cstddef>
+#include <string>
+
+#include "rapidjson/document.h"
+#include "rapidjson/reader.h"
+#include "rapidjson/schema.h"
+#include "rapidjson/stringbuffer.h"
+
+// Why a JSON-format launch parameter or app description was rejected.
+struct JsonError {
+  enum class Code { kNone, kParse, kSchema };
+
+  Code code = Code::kNone;
+  // kParse: where the document stopped being valid JSON.
+  rapidjson::ParseErrorCode parse_error = rapidjson::kParseErrorNone;
+  size_t offset = 0;
+  // kSchema: JSON pointer to the offending value and the schema keyword it
+  // failed, e.g. "/displayAffinity" and "type".
+  std::string pointer;
+  std::string keyword;
+
+  std::string ToString() const;
+};
+
+namespace json_schema {
+
+// Compiled on first use and kept for the lifetime of the process. The
+// zygote compiles them before forking so launches share them.
+const rapidjson::SchemaDocument& LaunchParams();
+const rapidjson::SchemaDocument& AppInfo();
+
+// Bytes of validation state kept on the stack, enough for the schemas
+// above; deeper documents spill to the heap.
+constexpr size_t kStateBufferSize = 2048;
+
+typedef rapidjson::MemoryPoolAllocator<> StateAllocator;
+
+template <typename Handler>
+using Validator = rapidjson::GenericSchemaValidator<rapidjson::SchemaDocument,
+                                                   Handler, StateAllocator>;
+
+// Fills |error| from a validator that stopped with |result|.
+template <typename Handler>
+void SetError(const Validator<Handler>& validator,
+              rapidjson::ParseResult result,
+              JsonError* error) {
+  if (!error)
+    return;
+  const char* keyword = validator.IsValid() ? nullptr
+                                            : validator.GetInvalidSchemaKeyword();
+  if (keyword) {
+    rapidjson::StringBuffer pointer;
+    validator.GetInvalidDocumentPointer().Stringify(pointer);
+    error->code = JsonError::Code::kSchema;
+    error->pointer.assign(pointer.GetString(), pointer.GetSize());
+    error->keyword = keyword;
+  } else {
+    // Malformed JSON, or the handler itself gave up.
+    error->code = JsonError::Code::kParse;
+    error->parse_error = result.Code();
+    error->offset = result.Offset();
+  }
+}
+
+// Parses |is| into |handler| with every SAX event checked against |schema|
+// before it is forwarded, so |handler| may rely on the value types the
+// schema declares. Stops at the first violation.
+template <unsigned kParseFlags, typename InputStream, typename Handler>
+bool Parse(const rapidjson::SchemaDocument& schema,
+           InputStream& is,
+           Handler& handler,
+           JsonError* error) {
+  char buffer[kStateBufferSize];
+  StateAllocator allocator(buffer, sizeof(buffer));
+  Validator<Handler> validator(schema, handler, &allocator);
+
+  rapidjson::Reader reader;
+  rapidjson::ParseResult result = reader.Parse<kParseFlags>(is, validator);
+  if (result.IsError()) {
+    SetError(validator, result, error);
+    return false;
+  }
+  return true;
+}
+
+// Like Parse(), for a value that is already parsed.
+template <typename Handler>
+bool Accept(const rapidjson::SchemaDocument& schema,
+            const rapidjson::Value& value,
+            Handler& handler,
+            JsonError* error) {
+  char buffer[kStateBufferSize];
+  StateAllocator allocator(buffer, sizeof(buffer));
+  Validator<Handler> validator(schema, handler, &allocator);
+
+  if (!value.Accept(validator)) {
+    SetError(validator, rapidjson::ParseResult(rapidjson::kParseErrorTermination, 0),
+             error);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace json_schema
+
+#endif  // FLUTTER_RUNNER_JSON_SCHEMA_H_
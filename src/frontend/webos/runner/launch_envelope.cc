@@ -0,0 +1,48 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "launch_envelope.h"
+
+#include <string.h>
+
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+namespace {
+
+// Enough for a typical request and its document in one chunk.
+constexpr size_t kArenaChunkSize = 16 * 1024;
+
+}  // namespace
+
+LaunchEnvelope::LaunchEnvelope() : arena_(kArenaChunkSize) {}
+
+LaunchEnvelope::~LaunchEnvelope() {
+  // Documents refer to the arena.
+  documents_.clear();
+}
+
+const rapidjson::Value* LaunchEnvelope::Parse(std::string_view json) {
+  char* text = static_cast<char*>(arena_.Malloc(json.size() + 1));
+  memcpy(text, json.data(), json.size());
+  text[json.size()] = '\0';
+
+  documents_.emplace_back(&arena_);
+  rapidjson::Document& document = documents_.back();
+  document.ParseInsitu(text);
+  return document.HasParseError() ? nullptr : &document;
+}
+
+std::string_view LaunchEnvelope::ToString(const rapidjson::Value& value) const {
+  for (const auto& entry : serialized_) {
+    if (entry.first == &value)
+      return entry.second;
+  }
+
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  value.Accept(writer);
+  serialized_.emplace_back(&value, std::string(buffer.GetString(), buffer.GetSize()));
+  return serialized_.back().second;
+}
@@ -0,0 +1,46 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_RUNNER_LAUNCH_ENVELOPE_H_
+#define FLUTTER_RUNNER_LAUNCH_ENVELOPE_H_
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "rapidjson/document.h"
+
+// Owns the JSON-format launch request passed by the launcher, e.g.
+// {"appDesc":{...}, "parameters":{...}}, parsed exactly once.
+//
+// The request is copied into an arena and parsed in place, so strings of
+// the document point into the copy and the document itself lives in the
+// same arena. Values handed out stay valid for the lifetime of the
+// envelope; consumers read them directly instead of re-parsing text.
+class LaunchEnvelope {
+ public:
+  LaunchEnvelope();
+  ~LaunchEnvelope();
+
+  // Prevent copying.
+  LaunchEnvelope(LaunchEnvelope const&) = delete;
+  LaunchEnvelope& operator=(LaunchEnvelope const&) = delete;
+
+  // Returns the root of |json|, or nullptr if it is not valid JSON. Every
+  // request parsed is kept.
+  const rapidjson::Value* Parse(std::string_view json);
+
+  // |value| of this envelope as JSON text, e.g. the launch parameters for
+  // the Dart entrypoint. Written on first use only.
+  std::string_view ToString(const rapidjson::Value& value) const;
+
+ private:
+  rapidjson::MemoryPoolAllocator<> arena_;
+  std::deque<rapidjson::Document> documents_;
+  // A deque keeps the strings in place for the views handed out.
+  mutable std::deque<std::pair<const rapidjson::Value*, std::string>> serialized_;
+};
+
+#endif  // FLUTTER_RUNNER_LAUNCH_ENVELOPE_H_
@@ -4,8 +4,708 @@
 
 #include "logger.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "settings_conf.h"
+
 PmLogContext GetPmLogContext()
 {
   static PmLogContext ctx = PmLogGetContextInline(FLUTTER_LOG_CONTEXT);
   return ctx;
 }
+
+namespace logging {
+namespace {
+
+// Per thread. A record is at most a quarter of it, so a burst of a few
+// JSON payloads still fits; records that do not are dropped and counted.
+constexpr size_t kRingSize = 64 * 1024;
+constexpr size_t kMaxRecordSize = kRingSize / 4;
+// Longer string arguments are cut, as PmLog would do anyway.
+constexpr size_t kMaxStringLength = 4096;
+constexpr size_t kMaxArgs = 32;
+// How long records may sit in a ring; errors wake the writer at once.
+constexpr std::chrono::milliseconds kDrainInterval(20);
+// File sink writes are batched up to this size.
+constexpr size_t kFileBatchSize = 16 * 1024;
+
+constexpr uint8_t kWrapMarker = 0xff;
+constexpr uint32_t kNullString = UINT32_MAX;
+
+// Records are laid out as a RecordHeader, then one ArgHeader per argument
+// followed by 8 bytes of value, or by the NUL-terminated string padded to
+// 8 bytes.
+struct RecordHeader {
+  uint32_t size;
+  uint8_t level;
+  uint8_t count;
+  uint16_t reserved;
+  uint64_t time_ns;
+  const char* format;
+};
+
+struct ArgHeader {
+  uint8_t type;
+  uint8_t reserved[3];
+  uint32_t length;
+};
+
+constexpr size_t Align(size_t size) {
+  return (size + 7) & ~size_t(7);
+}
+
+uint64_t NowNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull +
+         static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// Single producer, single consumer byte ring. Positions only grow; the
+// producer owns head_, the writer thread owns tail_.
+class Ring {
+ public:
+  // Returns room for |size| bytes (a multiple of 8), or nullptr if the
+  // ring is full. The record is published by Commit().
+  char* Reserve(size_t size) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    const uint64_t tail = tail_.load(std::memory_order_acquire);
+    const size_t offset = head % kRingSize;
+    const size_t contiguous = kRingSize - offset;
+    if (size > contiguous) {
+      if (head - tail + contiguous + size > kRingSize)
+        return nullptr;
+      // Too close to the end; skip to the start.
+      RecordHeader* marker = reinterpret_cast<RecordHeader*>(data_ + offset);
+      marker->size = static_cast<uint32_t>(contiguous);
+      marker->level = kWrapMarker;
+      head += contiguous;
+      reserved_ = head + size;
+      return data_;
+    }
+    if (head - tail + size > kRingSize)
+      return nullptr;
+    reserved_ = head + size;
+    return data_ + offset;
+  }
+
+  void Commit() {
+    head_.store(reserved_, std::memory_order_release);
+  }
+
+  size_t Used() const {
+    return head_.load(std::memory_order_relaxed) -
+           tail_.load(std::memory_order_relaxed);
+  }
+
+  // Writer thread: the oldest record, or nullptr if there is none.
+  const RecordHeader* Peek() {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    while (tail != head) {
+      const RecordHeader* record =
+          reinterpret_cast<const RecordHeader*>(data_ + tail % kRingSize);
+      if (record->level != kWrapMarker)
+        return record;
+      tail += record->size;
+      tail_.store(tail, std::memory_order_release);
+    }
+    return nullptr;
+  }
+
+  void Pop(const RecordHeader* record) {
+    tail_.store(tail_.load(std::memory_order_relaxed) + record->size,
+                std::memory_order_release);
+  }
+
+  // Set once the owning thread has exited.
+  std::atomic<bool> retired{false};
+  std::atomic<uint64_t> dropped{0};
+
+ private:
+  alignas(64) std::atomic<uint64_t> head_{0};
+  uint64_t reserved_ = 0;
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  alignas(64) char data_[kRingSize];
+};
+
+// printf() of a single conversion |spec| into |out|.
+template <typename... T>
+void AppendPrintf(std::string* out, const char* spec, T... values) {
+  char stack[128];
+  int length = snprintf(stack, sizeof(stack), spec, values...);
+  if (length < 0)
+    return;
+  if (static_cast<size_t>(length) < sizeof(stack)) {
+    out->append(stack, static_cast<size_t>(length));
+    return;
+  }
+  const size_t start = out->size();
+  out->resize(start + static_cast<size_t>(length) + 1);
+  snprintf(&(*out)[start], static_cast<size_t>(length) + 1, spec, values...);
+  out->resize(start + static_cast<size_t>(length));
+}
+
+template <typename T>
+void AppendValue(std::string* out, const char* spec, const int* stars,
+                 int star_count, T value) {
+  switch (star_count) {
+    case 0:
+      AppendPrintf(out, spec, value);
+      break;
+    case 1:
+      AppendPrintf(out, spec, stars[0], value);
+      break;
+    default:
+      AppendPrintf(out, spec, stars[0], stars[1], value);
+      break;
+  }
+}
+
+template <typename Signed, typename Unsigned>
+void AppendInteger(std::string* out, const char* spec, const int* stars,
+                   int star_count, bool is_signed, const Arg& arg) {
+  if (is_signed)
+    AppendValue(out, spec, stars, star_count, static_cast<Signed>(arg.i));
+  else
+    AppendValue(out, spec, stars, star_count, static_cast<Unsigned>(arg.u));
+}
+
+// Expands |format| with |args| the way printf() would. Conversions whose
+// argument is missing or of another kind are copied as they are.
+void Format(const char* format, const Arg* args, size_t count, std::string* out) {
+  size_t next = 0;
+  const char* p = format;
+  while (*p) {
+    const char* percent = strchr(p, '%');
+    if (!percent) {
+      out->append(p);
+      break;
+    }
+    out->append(p, percent - p);
+    p = percent + 1;
+    if (*p == '%') {
+      out->push_back('%');
+      ++p;
+      continue;
+    }
+
+    int stars[2];
+    int star_count = 0;
+    bool complete = true;
+    auto take_star = [&]() {
+      if (next < count && args[next].type == ArgType::kSigned)
+        stars[star_count++] = static_cast<int>(args[next].i);
+      else
+        complete = false;
+      ++next;
+    };
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0')
+      ++p;
+    if (*p == '*') {
+      take_star();
+      ++p;
+    }
+    while (*p >= '0' && *p <= '9')
+      ++p;
+    if (*p == '.') {
+      if (*++p == '*') {
+        take_star();
+        ++p;
+      }
+      while (*p >= '0' && *p <= '9')
+        ++p;
+    }
+    const char* modifier = p;
+    while (*p == 'h' || *p == 'l' || *p == 'L' || *p == 'q' || *p == 'j' ||
+           *p == 'z' || *p == 't')
+      ++p;
+    if (!*p) {
+      out->append(percent);
+      break;
+    }
+
+    const char conversion = *p++;
+    const std::string spec(percent, p - percent);
+    const Arg* arg = next < count ? &args[next] : nullptr;
+    ++next;
+    if (!complete || !arg) {
+      out->append(spec);
+      continue;
+    }
+
+    const bool is_signed = arg->type == ArgType::kSigned;
+    const bool is_integer = is_signed || arg->type == ArgType::kUnsigned;
+    switch (conversion) {
+      case 'd':
+      case 'i':
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X': {
+        if (!is_integer) {
+          out->append(spec);
+          break;
+        }
+        const size_t length = p - 1 - modifier;
+        if (length == 2 && modifier[0] == 'l')
+          AppendInteger<long long, unsigned long long>(out, spec.c_str(), stars,
+                                                       star_count, is_signed, *arg);
+        else if (length == 1 && modifier[0] == 'l')
+          AppendInteger<long, unsigned long>(out, spec.c_str(), stars,
+                                             star_count, is_signed, *arg);
+        else if (length == 1 && modifier[0] == 'q')
+          AppendInteger<long long, unsigned long long>(out, spec.c_str(), stars,
+                                                       star_count, is_signed, *arg);
+        else if (length == 1 && modifier[0] == 'j')
+          AppendInteger<intmax_t, uintmax_t>(out, spec.c_str(), stars,
+                                             star_count, is_signed, *arg);
+        else if (length == 1 && modifier[0] == 'z')
+          AppendInteger<ssize_t, size_t>(out, spec.c_str(), stars, star_count,
+                                         is_signed, *arg);
+        else if (length == 1 && modifier[0] == 't')
+          AppendInteger<ptrdiff_t, size_t>(out, spec.c_str(), stars,
+                                           star_count, is_signed, *arg);
+        else
+          AppendInteger<int, unsigned>(out, spec.c_str(), stars, star_count,
+                                       is_signed, *arg);
+        break;
+      }
+      case 'c':
+        if (is_integer)
+          AppendValue(out, spec.c_str(), stars, star_count,
+                      static_cast<int>(arg->i));
+        else
+          out->append(spec);
+        break;
+      case 'e':
+      case 'E':
+      case 'f':
+      case 'F':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        if (arg->type != ArgType::kDouble) {
+          out->append(spec);
+        } else if (modifier[0] == 'L') {
+          AppendValue(out, spec.c_str(), stars, star_count,
+                      static_cast<long double>(arg->d));
+        } else {
+          AppendValue(out, spec.c_str(), stars, star_count, arg->d);
+        }
+        break;
+      case 's':
+        if (arg->type == ArgType::kString)
+          AppendValue(out, spec.c_str(), stars, star_count,
+                      arg->s ? arg->s : "(null)");
+        else
+          out->append(spec);
+        break;
+      case 'p':
+        if (arg->type == ArgType::kPointer || arg->type == ArgType::kString)
+          AppendValue(out, spec.c_str(), stars, star_count, arg->p);
+        else
+          out->append(spec);
+        break;
+      case 'n':
+        // Nothing to store the count to.
+        break;
+      default:
+        out->append(spec);
+        break;
+    }
+  }
+}
+
+class Sink {
+ public:
+  Sink() {
+    const char* path = getenv(FLUTTER_LOG_FILE);
+    if (path && *path) {
+      fd_ = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+      if (fd_ < 0)
+        PmLogWarning(GetPmLogContext(), FLUTTER_MSGID, 0,
+                     "Cannot open log file %s, using PmLog", path);
+    }
+  }
+
+  // Writes or queues one formatted message.
+  void Write(int level, uint64_t time_ns, const std::string& message) {
+    if (fd_ < 0) {
+      const char* text = message.c_str();
+      switch (level) {
+        case FLUTTER_LOG_LEVEL_CRITICAL:
+          PmLogCritical(GetPmLogContext(), FLUTTER_MSGID, 0, "%s", text);
+          break;
+        case FLUTTER_LOG_LEVEL_ERROR:
+          PmLogError(GetPmLogContext(), FLUTTER_MSGID, 0, "%s", text);
+          break;
+        case FLUTTER_LOG_LEVEL_WARNING:
+          PmLogWarning(GetPmLogContext(), FLUTTER_MSGID, 0, "%s", text);
+          break;
+        case FLUTTER_LOG_LEVEL_INFO:
+          PmLogInfo(GetPmLogContext(), FLUTTER_MSGID, 0, "%s", text);
+          break;
+        default:
+          PmLogDebug(GetPmLogContext(), "%s", text);
+          break;
+      }
+      return;
+    }
+
+    static const char kLevels[] = "??CEW?ID";
+    char prefix[48];
+    int length = snprintf(prefix, sizeof(prefix), "%llu.%06llu %c ",
+                          static_cast<unsigned long long>(time_ns / 1000000000ull),
+                          static_cast<unsigned long long>(time_ns / 1000 % 1000000),
+                          kLevels[level & 7]);
+    batch_.append(prefix, static_cast<size_t>(length));
+    batch_.append(message);
+    batch_.push_back('\n');
+    if (batch_.size() >= kFileBatchSize)
+      Flush();
+  }
+
+  void Flush() {
+    const char* data = batch_.data();
+    size_t left = batch_.size();
+    while (left > 0) {
+      ssize_t written = write(fd_, data, left);
+      if (written < 0 && errno == EINTR)
+        continue;
+      if (written <= 0)
+        break;
+      data += written;
+      left -= static_cast<size_t>(written);
+    }
+    batch_.clear();
+  }
+
+ private:
+  int fd_ = -1;
+  std::string batch_;
+};
+
+// Owns the rings and the thread writing them out. Created on first use;
+// a forked child starts over with a new one.
+class Backend {
+ public:
+  Backend() {
+    running_ = pthread_create(&thread_, nullptr, &Backend::Run, this) == 0;
+  }
+
+  bool Running() const { return running_.load(std::memory_order_acquire); }
+
+  std::shared_ptr<Ring> AddRing() {
+    std::shared_ptr<Ring> ring = std::make_shared<Ring>();
+    std::lock_guard<std::mutex> lock(mutex_);
+    rings_.push_back(ring);
+    return ring;
+  }
+
+  void Wake() {
+    wake_.store(true, std::memory_order_relaxed);
+    cv_.notify_one();
+  }
+
+  void Flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const uint64_t ticket = ++flush_requested_;
+    wake_.store(true, std::memory_order_relaxed);
+    cv_.notify_all();
+    cv_.wait(lock, [&]() { return flushed_ >= ticket || !Running(); });
+  }
+
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!Running())
+        return;
+      stop_ = true;
+    }
+    cv_.notify_all();
+    pthread_join(thread_, nullptr);
+  }
+
+  // Formats and writes one message on the calling thread.
+  void WriteNow(int level, const char* format, const Arg* args, size_t count) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    message_.clear();
+    Format(format, args, count, &message_);
+    sink_.Write(level, NowNs(), message_);
+    sink_.Flush();
+  }
+
+  // Held while writing, so fork() never happens in the middle of a sink
+  // call made by the writer thread.
+  std::mutex& write_mutex() { return write_mutex_; }
+
+ private:
+  static void* Run(void* self) {
+    static_cast<Backend*>(self)->Loop();
+    return nullptr;
+  }
+
+  void Loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      cv_.wait_for(lock, kDrainInterval, [&]() {
+        return stop_ || wake_.load(std::memory_order_relaxed);
+      });
+      wake_.store(false, std::memory_order_relaxed);
+      const bool stop = stop_;
+      const uint64_t ticket = flush_requested_;
+      snapshot_ = rings_;
+      lock.unlock();
+
+      Drain();
+
+      lock.lock();
+      // Rings of exited threads go once they are empty.
+      for (size_t i = 0; i < rings_.size();) {
+        if (rings_[i]->retired.load(std::memory_order_acquire) &&
+            !rings_[i]->Peek()) {
+          rings_[i] = rings_.back();
+          rings_.pop_back();
+        } else {
+          ++i;
+        }
+      }
+      snapshot_.clear();
+      flushed_ = ticket;
+      cv_.notify_all();
+      if (stop)
+        break;
+    }
+    running_.store(false, std::memory_order_release);
+  }
+
+  // Writes everything in the rings, oldest first across threads.
+  void Drain() {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    for (;;) {
+      Ring* oldest = nullptr;
+      const RecordHeader* record = nullptr;
+      for (const std::shared_ptr<Ring>& ring : snapshot_) {
+        const RecordHeader* head = ring->Peek();
+        if (head && (!record || head->time_ns < record->time_ns)) {
+          oldest = ring.get();
+          record = head;
+        }
+      }
+      if (!record)
+        break;
+      Write(*record);
+      oldest->Pop(record);
+    }
+
+    for (const std::shared_ptr<Ring>& ring : snapshot_) {
+      const uint64_t dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+      if (dropped) {
+        message_ = "Dropped " + std::to_string(dropped) + " log records";
+        sink_.Write(FLUTTER_LOG_LEVEL_WARNING, NowNs(), message_);
+      }
+    }
+    sink_.Flush();
+  }
+
+  void Write(const RecordHeader& record) {
+    args_.resize(record.count);
+    const char* p = reinterpret_cast<const char*>(&record + 1);
+    for (Arg& arg : args_) {
+      const ArgHeader* header = reinterpret_cast<const ArgHeader*>(p);
+      p += sizeof(ArgHeader);
+      arg.type = static_cast<ArgType>(header->type);
+      if (arg.type == ArgType::kString) {
+        arg.s = header->length == kNullString ? nullptr : p;
+        p += header->length == kNullString ? 0 : Align(header->length + 1);
+      } else {
+        memcpy(&arg.u, p, sizeof(arg.u));
+        p += sizeof(arg.u);
+      }
+    }
+    message_.clear();
+    Format(record.format, args_.data(), args_.size(), &message_);
+    sink_.Write(record.level, record.time_ns, message_);
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<std::shared_ptr<Ring>> rings_;
+  bool stop_ = false;
+  uint64_t flush_requested_ = 0;
+  uint64_t flushed_ = 0;
+  std::atomic<bool> wake_{false};
+  std::atomic<bool> running_{false};
+  pthread_t thread_;
+
+  std::mutex write_mutex_;
+  Sink sink_;
+  // Writer thread only.
+  std::vector<std::shared_ptr<Ring>> snapshot_;
+  std::vector<Arg> args_;
+  std::string message_;
+};
+
+std::mutex g_backend_mutex;
+std::atomic<Backend*> g_backend{nullptr};
+
+void StopBackend() {
+  if (Backend* backend = g_backend.load(std::memory_order_acquire))
+    backend->Stop();
+}
+
+// The zygote forks with the writer thread running. Forking is held off
+// while a batch is being written; the child drops the parent's backend,
+// whose thread does not exist there, and its pending records, which the
+// parent writes.
+void PrepareFork() {
+  g_backend_mutex.lock();
+  if (Backend* backend = g_backend.load(std::memory_order_relaxed))
+    backend->write_mutex().lock();
+}
+
+void ParentAfterFork() {
+  if (Backend* backend = g_backend.load(std::memory_order_relaxed))
+    backend->write_mutex().unlock();
+  g_backend_mutex.unlock();
+}
+
+void ChildAfterFork() {
+  // Leaked: its locks are held and its thread is gone.
+  g_backend.store(nullptr, std::memory_order_relaxed);
+  g_backend_mutex.unlock();
+}
+
+Backend* GetBackend() {
+  Backend* backend = g_backend.load(std::memory_order_acquire);
+  if (backend)
+    return backend;
+
+  std::lock_guard<std::mutex> lock(g_backend_mutex);
+  backend = g_backend.load(std::memory_order_relaxed);
+  if (!backend) {
+    static bool registered = false;
+    if (!registered) {
+      registered = true;
+      pthread_atfork(&PrepareFork, &ParentAfterFork, &ChildAfterFork);
+      atexit(&StopBackend);
+    }
+    // Never deleted; threads may log until the very end.
+    backend = new Backend();
+    g_backend.store(backend, std::memory_order_release);
+  }
+  return backend;
+}
+
+struct ThreadRing {
+  ~ThreadRing() {
+    if (ring)
+      ring->retired.store(true, std::memory_order_release);
+  }
+
+  std::shared_ptr<Ring> ring;
+  Backend* owner = nullptr;
+};
+
+thread_local ThreadRing t_ring;
+
+}  // namespace
+
+void Submit(int level, const char* format, uint64_t bounded,
+            const Arg* args, size_t count) {
+  Backend* backend = GetBackend();
+  if (level <= FLUTTER_LOG_LEVEL_CRITICAL || count > kMaxArgs ||
+      !backend->Running()) {
+    backend->WriteNow(level, format, args, count);
+    return;
+  }
+
+  if (t_ring.owner != backend) {
+    if (t_ring.ring)
+      t_ring.ring->retired.store(true, std::memory_order_release);
+    t_ring.ring = backend->AddRing();
+    t_ring.owner = backend;
+  }
+  Ring* ring = t_ring.ring.get();
+
+  uint32_t lengths[kMaxArgs];
+  size_t size = sizeof(RecordHeader);
+  for (size_t i = 0; i < count; ++i) {
+    size += sizeof(ArgHeader);
+    if (args[i].type != ArgType::kString) {
+      size += sizeof(uint64_t);
+      continue;
+    }
+    if (!args[i].s) {
+      lengths[i] = kNullString;
+      continue;
+    }
+    size_t limit = kMaxStringLength;
+    if ((bounded >> i & 1) && i > 0 && args[i - 1].type == ArgType::kSigned)
+      limit = args[i - 1].i < 0 ? limit
+                                : std::min<size_t>(limit, args[i - 1].i);
+    lengths[i] = static_cast<uint32_t>(strnlen(args[i].s, limit));
+    size += Align(lengths[i] + 1);
+  }
+
+  char* p = size <= kMaxRecordSize ? ring->Reserve(size) : nullptr;
+  if (!p) {
+    ring->dropped.fetch_add(1, std::memory_order_relaxed);
+    backend->Wake();
+    return;
+  }
+
+  RecordHeader* record = reinterpret_cast<RecordHeader*>(p);
+  record->size = static_cast<uint32_t>(size);
+  record->level = static_cast<uint8_t>(level);
+  record->count = static_cast<uint8_t>(count);
+  record->reserved = 0;
+  record->time_ns = NowNs();
+  record->format = format;
+  p += sizeof(RecordHeader);
+  for (size_t i = 0; i < count; ++i) {
+    ArgHeader* header = reinterpret_cast<ArgHeader*>(p);
+    p += sizeof(ArgHeader);
+    header->type = static_cast<uint8_t>(args[i].type);
+    if (args[i].type != ArgType::kString) {
+      header->length = sizeof(uint64_t);
+      memcpy(p, &args[i].u, sizeof(uint64_t));
+      p += sizeof(uint64_t);
+      continue;
+    }
+    header->length = lengths[i];
+    if (lengths[i] == kNullString)
+      continue;
+    memcpy(p, args[i].s, lengths[i]);
+    p[lengths[i]] = '\0';
+    p += Align(lengths[i] + 1);
+  }
+  ring->Commit();
+
+  if (level <= FLUTTER_LOG_LEVEL_ERROR || ring->Used() > kRingSize / 2)
+    backend->Wake();
+}
+
+void Flush() {
+  Backend* backend = g_backend.load(std::memory_order_acquire);
+  if (backend)
+    backend->Flush();
+}
+
+}  // namespace logging
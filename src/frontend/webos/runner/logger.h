@@ -5,28 +5,163 @@
 #ifndef FLUTTER_WAYLAND_CLIENT_LOGGER_H_
 #define FLUTTER_WAYLAND_CLIENT_LOGGER_H_
 
+#include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 
 #include <cstdio>
 #include <iostream>
 #include <sstream>
+#include <type_traits>
 
 #include <PmLogLib.h>
 
 #define FLUTTER_LOG_CONTEXT "flutter"
 #define FLUTTER_MSGID "runner"
 
+// Levels compiled in, numbered as in PmLog. Calls above FLUTTER_LOG_LEVEL
+// are discarded at compile time, arguments included.
+#define FLUTTER_LOG_LEVEL_NONE 0
+#define FLUTTER_LOG_LEVEL_CRITICAL 2
+#define FLUTTER_LOG_LEVEL_ERROR 3
+#define FLUTTER_LOG_LEVEL_WARNING 4
+#define FLUTTER_LOG_LEVEL_INFO 6
+#define FLUTTER_LOG_LEVEL_DEBUG 7
+
+#ifndef FLUTTER_LOG_LEVEL
+#ifdef NDEBUG
+#define FLUTTER_LOG_LEVEL FLUTTER_LOG_LEVEL_INFO
+#else
+#define FLUTTER_LOG_LEVEL FLUTTER_LOG_LEVEL_DEBUG
+#endif
+#endif
+
 extern PmLogContext GetPmLogContext();
 
-#define LOG_CRITICAL(...) \
-          PmLogCritical(GetPmLogContext(), FLUTTER_MSGID, 0, ##__VA_ARGS__)
-#define LOG_ERROR(...) \
-        PmLogError(GetPmLogContext(), FLUTTER_MSGID, 0,##__VA_ARGS__)
-#define LOG_WARNING(...) \
-        PmLogWarning(GetPmLogContext(), FLUTTER_MSGID, 0, ##__VA_ARGS__)
-#define LOG_INFO(...) \
-        PmLogInfo(GetPmLogContext(), FLUTTER_MSGID, 0, ##__VA_ARGS__)
-#define LOG_DEBUG(...) \
-        PmLogDebug(GetPmLogContext(), ##__VA_ARGS__)
+// Log calls capture the format string and their raw arguments into a ring
+// owned by the calling thread; a background thread formats the records and
+// writes them to PmLog, or to the file named by FLUTTER_LOG_FILE, in
+// batches. String arguments are copied, so temporaries such as c_str() of
+// a local may be passed as usual. Critical messages are written before the
+// call returns.
+namespace logging {
+
+enum class ArgType : uint8_t { kSigned, kUnsigned, kDouble, kPointer, kString };
+
+// A printf argument as captured by the caller.
+struct Arg {
+  ArgType type;
+  union {
+    int64_t i;
+    uint64_t u;
+    double d;
+    const void* p;
+    const char* s;
+  };
+};
+
+template <typename T>
+struct UnsupportedArg : std::false_type {};
+
+template <typename T>
+inline Arg MakeArg(T value) {
+  Arg arg;
+  if constexpr (std::is_same<T, const char*>::value ||
+                std::is_same<T, char*>::value) {
+    arg.type = ArgType::kString;
+    arg.s = value;
+  } else if constexpr (std::is_enum<T>::value) {
+    return MakeArg(static_cast<typename std::underlying_type<T>::type>(value));
+  } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+    arg.type = ArgType::kSigned;
+    arg.i = value;
+  } else if constexpr (std::is_integral<T>::value) {
+    arg.type = ArgType::kUnsigned;
+    arg.u = value;
+  } else if constexpr (std::is_floating_point<T>::value) {
+    arg.type = ArgType::kDouble;
+    arg.d = static_cast<double>(value);
+  } else if constexpr (std::is_pointer<T>::value ||
+                       std::is_null_pointer<T>::value) {
+    arg.type = ArgType::kPointer;
+    arg.p = value;
+  } else {
+    static_assert(UnsupportedArg<T>::value, "Not a printf argument");
+  }
+  return arg;
+}
+
+// Bit i is set if argument i is a "%.*s" string, whose length is bounded
+// by the argument before it rather than by a terminating NUL.
+constexpr uint64_t BoundedStrings(const char* format) {
+  uint64_t mask = 0;
+  unsigned index = 0;
+  for (const char* p = format; *p; ++p) {
+    if (*p != '%')
+      continue;
+    if (*++p == '%')
+      continue;
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0')
+      ++p;
+    if (*p == '*') {
+      ++index;
+      ++p;
+    }
+    while (*p >= '0' && *p <= '9')
+      ++p;
+    bool bounded = false;
+    if (*p == '.') {
+      if (*++p == '*') {
+        ++index;
+        ++p;
+        bounded = true;
+      }
+      while (*p >= '0' && *p <= '9')
+        ++p;
+    }
+    while (*p == 'h' || *p == 'l' || *p == 'L' || *p == 'q' || *p == 'j' ||
+           *p == 'z' || *p == 't')
+      ++p;
+    if (!*p)
+      break;
+    if (*p == 's' && bounded && index < 64)
+      mask |= uint64_t(1) << index;
+    ++index;
+  }
+  return mask;
+}
+
+void Submit(int level, const char* format, uint64_t bounded,
+            const Arg* args, size_t count);
+
+template <typename... Args>
+inline void Post(int level, const char* format, uint64_t bounded, Args... args) {
+  const Arg captured[] = {MakeArg(args)..., Arg()};
+  Submit(level, format, bounded, captured, sizeof...(Args));
+}
+
+// Blocks until everything logged so far has been written.
+void Flush();
+
+}  // namespace logging
+
+#define FLUTTER_LOG(level, format, ...)                                      \
+  do {                                                                       \
+    if constexpr (level <= FLUTTER_LOG_LEVEL) {                              \
+      constexpr uint64_t kBoundedStrings = logging::BoundedStrings(format); \
+      logging::Post(level, format, kBoundedStrings, ##__VA_ARGS__);         \
+    }                                                                        \
+  } while (0)
+
+#define LOG_CRITICAL(format, ...) \
+          FLUTTER_LOG(FLUTTER_LOG_LEVEL_CRITICAL, format, ##__VA_ARGS__)
+#define LOG_ERROR(format, ...) \
+        FLUTTER_LOG(FLUTTER_LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#define LOG_WARNING(format, ...) \
+        FLUTTER_LOG(FLUTTER_LOG_LEVEL_WARNING, format, ##__VA_ARGS__)
+#define LOG_INFO(format, ...) \
+        FLUTTER_LOG(FLUTTER_LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#define LOG_DEBUG(format, ...) \
+        FLUTTER_LOG(FLUTTER_LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
 
 #endif  // FLUTTER_WAYLAND_CLIENT_LOGGER_H_
@@ -0,0 +1,104 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "loop_telemetry.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+std::atomic<bool> LoopTelemetry::dump_requested_{false};
+
+namespace {
+
+std::atomic<int> g_wake_fd{-1};
+
+void OnDumpSignal(int) {
+  const int saved_errno = errno;
+  LoopTelemetry::RequestDump();
+  const int fd = g_wake_fd.load(std::memory_order_relaxed);
+  if (fd >= 0) {
+    uint64_t one = 1;
+    ssize_t ignored = write(fd, &one, sizeof(one));
+    (void)ignored;
+  }
+  errno = saved_errno;
+}
+
+void DumpHistogram(FILE* out,
+                   const char* name,
+                   const LoopTelemetry::Histogram& histogram) {
+  fprintf(out,
+          "%-10s count=%llu min=%llu p50=%llu p90=%llu p99=%llu p999=%llu "
+          "max=%llu mean=%llu\n",
+          name, static_cast<unsigned long long>(histogram.Count()),
+          static_cast<unsigned long long>(histogram.Min()),
+          static_cast<unsigned long long>(histogram.ValueAtPermille(500)),
+          static_cast<unsigned long long>(histogram.ValueAtPermille(900)),
+          static_cast<unsigned long long>(histogram.ValueAtPermille(990)),
+          static_cast<unsigned long long>(histogram.ValueAtPermille(999)),
+          static_cast<unsigned long long>(histogram.Max()),
+          static_cast<unsigned long long>(histogram.Mean()));
+}
+
+}  // namespace
+
+uint64_t LoopTelemetry::Histogram::BucketValue(int index) {
+  if (index < kSubBuckets)
+    return static_cast<uint64_t>(index);
+  const int shift = index / kSubBuckets - 1;
+  const uint64_t sub = static_cast<uint64_t>(index % kSubBuckets);
+  return (kSubBuckets + sub) << shift;
+}
+
+uint64_t LoopTelemetry::Histogram::ValueAtPermille(uint32_t permille) const {
+  if (count_ == 0)
+    return 0;
+
+  const uint64_t target =
+      std::max<uint64_t>(1, (count_ * permille + 999) / 1000);
+  uint64_t seen = 0;
+  for (int i = 0; i < kBuckets; i++) {
+    seen += counts_[i];
+    if (seen >= target)
+      return std::max(BucketValue(i), Min());
+  }
+  return max_;
+}
+
+void LoopTelemetry::InstallSignalHandler(int wake_fd) {
+  g_wake_fd.store(wake_fd, std::memory_order_relaxed);
+
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = OnDumpSignal;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGUSR1, &action, nullptr);
+}
+
+void LoopTelemetry::Dump(FILE* out) const {
+  fprintf(out, "# runner loop telemetry (ns)\n");
+  DumpHistogram(out, "dispatch", dispatch_);
+  DumpHistogram(out, "engine", engine_);
+  DumpHistogram(out, "lateness", lateness_);
+  DumpHistogram(out, "idle", idle_);
+
+  // Most recent iterations, oldest first.
+  const uint64_t head = head_.load(std::memory_order_acquire);
+  const uint64_t count = std::min<uint64_t>(head, kRingSize);
+  fprintf(out, "# last %llu iterations: dispatch,idle,lateness,engine\n",
+          static_cast<unsigned long long>(count));
+  for (uint64_t i = head - count; i < head; i++) {
+    const Sample& s = ring_[i & (kRingSize - 1)];
+    fprintf(out, "%llu,%llu,%llu,%llu\n",
+            static_cast<unsigned long long>(s.dispatch_ns),
+            static_cast<unsigned long long>(s.idle_ns),
+            static_cast<unsigned long long>(s.lateness_ns),
+            static_cast<unsigned long long>(s.engine_ns));
+  }
+}
@@ -0,0 +1,116 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_RUNNER_LOOP_TELEMETRY_H_
+#define FLUTTER_RUNNER_LOOP_TELEMETRY_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+// Per-iteration timings of the runner main loop.
+//
+// Record() is called from the loop thread only and costs a handful of
+// integer operations: the sample is stored into a lock-free ring of recent
+// iterations and folded into log-linear (HDR-style) histograms. Dumps are
+// requested with SIGUSR1 and written by the loop thread itself.
+class LoopTelemetry {
+ public:
+  struct Sample {
+    uint64_t dispatch_ns;  // view()->DispatchEvent()
+    uint64_t idle_ns;      // time blocked waiting for the next event
+    uint64_t lateness_ns;  // wakeup time past the requested deadline
+    uint64_t engine_ns;    // engine()->ProcessMessages()
+  };
+
+  class Histogram {
+   public:
+    // 16 linear sub-buckets per power of two: ~6% relative precision.
+    static constexpr int kSubBucketBits = 4;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+    void Record(uint64_t value) {
+      counts_[BucketIndex(value)]++;
+      count_++;
+      sum_ += value;
+      if (value > max_)
+        max_ = value;
+      if (value < min_)
+        min_ = value;
+    }
+
+    uint64_t Count() const { return count_; }
+    uint64_t Min() const { return count_ ? min_ : 0; }
+    uint64_t Max() const { return max_; }
+    uint64_t Mean() const { return count_ ? sum_ / count_ : 0; }
+    // Lower bound of the bucket holding the |permille|-th value.
+    uint64_t ValueAtPermille(uint32_t permille) const;
+
+   private:
+    static int BucketIndex(uint64_t value) {
+      if (value < kSubBuckets)
+        return static_cast<int>(value);
+      const int exponent = 63 - __builtin_clzll(value);
+      const int shift = exponent - kSubBucketBits;
+      return (shift + 1) * kSubBuckets +
+             static_cast<int>((value >> shift) & (kSubBuckets - 1));
+    }
+    static uint64_t BucketValue(int index);
+
+    uint32_t counts_[kBuckets] = {};
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+  };
+
+  static constexpr uint32_t kRingSize = 1024;  // power of two
+
+  LoopTelemetry() = default;
+  ~LoopTelemetry() = default;
+
+  // Prevent copying.
+  LoopTelemetry(LoopTelemetry const&) = delete;
+  LoopTelemetry& operator=(LoopTelemetry const&) = delete;
+
+  void Record(const Sample& sample) {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    ring_[head & (kRingSize - 1)] = sample;
+    head_.store(head + 1, std::memory_order_release);
+
+    dispatch_.Record(sample.dispatch_ns);
+    idle_.Record(sample.idle_ns);
+    lateness_.Record(sample.lateness_ns);
+    engine_.Record(sample.engine_ns);
+  }
+
+  // Routes SIGUSR1 to RequestDump() and wakes the loop through |wake_fd|
+  // (EventLoop::wake_fd()), so the dump is written on the next iteration
+  // whichever thread takes the signal and however long the loop would
+  // otherwise sleep. Pass -1 before the loop goes away.
+  static void InstallSignalHandler(int wake_fd);
+  static void RequestDump() {
+    dump_requested_.store(true, std::memory_order_relaxed);
+  }
+  static bool ConsumeDumpRequest() {
+    return dump_requested_.load(std::memory_order_relaxed) &&
+           dump_requested_.exchange(false, std::memory_order_relaxed);
+  }
+
+  void Dump(FILE* out) const;
+
+ private:
+  static std::atomic<bool> dump_requested_;
+
+  std::atomic<uint64_t> head_{0};
+  Sample ring_[kRingSize] = {};
+
+  Histogram dispatch_;
+  Histogram idle_;
+  Histogram lateness_;
+  Histogram engine_;
+};
+
+#endif  // FLUTTER_RUNNER_LOOP_TELEMETRY_H_
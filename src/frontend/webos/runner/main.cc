@@ -6,38 +6,111 @@
 #include <flutter/dart_project.h>
 #include <flutter/flutter_view_controller.h>
 
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
 #include <iostream>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "flutter_embedder_options.h"
 #include "flutter_embedder_loader.h"
 #include "flutter_window.h"
 #include "flutter_webos_window_properties.h"
 #include "flutter_launch_params.h"
+#include "json_schema.h"
+#include "runner_cache.h"
 #include "settings.h"
+#include "startup_orchestrator.h"
 #include "logger.h"
+#include "startup_tracer.h"
+#include "zygote.h"
 
-int main(int argc, char** argv) {
-  FlutterEmbedderOptions options;
-  try {
-    if (!options.Parse(argc, argv)) {
-      return 0;
+namespace {
+
+// FLUTTER_TEMP_HOME if it is private to this user, else none, which
+// disables the cache: a record planted by another user would decide what
+// code the app runs.
+std::string AppDescriptorCacheDir(const Settings& settings) {
+  const std::string& temp_home = settings.get(FLUTTER_TEMP_HOME);
+  if (!temp_home.empty() && runner_cache::IsPrivateDirectory(temp_home))
+    return temp_home;
+  return std::string();
+}
+
+// Command line arguments after argv[0] without the zygote options, which
+// must not carry over to the launched app.
+std::vector<std::string> LaunchArguments(int argc, char** argv) {
+  std::vector<std::string> args;
+  for (int i = 1; i < argc; i++) {
+    const std::string_view arg(argv[i]);
+    if (arg.rfind("--zygote=", 0) == 0 ||
+        arg.rfind("--zygote-launch=", 0) == 0)
+      continue;
+    if (arg == "-z" || arg == "-y") {
+      i++;  // Skips the socket path too.
+      continue;
     }
-  } catch(commandline::Exception& e){
-     LOG_ERROR("e: %s", e.what());
-     return 0;
+    args.emplace_back(arg);
+  }
+  return args;
+}
+
+// What a process forked by the zygote inherits from it.
+struct ZygoteChild {
+  // The embedder the zygote keeps loaded, RTLD_GLOBAL and resident.
+  std::string embedder_path;
+  // Command line that runs the same launch in a fresh process, terminated
+  // by nullptr.
+  std::vector<const char*> argv;
+};
+
+// Runs the app described by |options| until its window is closed.
+// |zygote| is set in processes forked by the zygote, which have the
+// platform settings loaded already.
+int RunApplication(FlutterEmbedderOptions& options,
+                   const ZygoteChild* zygote) {
+  const bool settings_loaded = zygote != nullptr;
+  // Start loading the libraries while the descriptors and configs are parsed.
+  StartupOrchestrator::getInstance().PreloadLibraries(options.AppId(),
+                                                      options.BundlePath(),
+                                                      options.DisplayBackend());
+
+  // Loaded first since it locates the app descriptor cache.
+  Settings& settings = Settings::getInstance();
+  if (!settings_loaded) {
+    TRACE_STARTUP_SCOPE("Settings::init");
+    settings.init();
   }
+  StartupTracer::EnableFromSettings();
 
   std::shared_ptr<FlutterApplicationDescription> app_desc = nullptr;
   std::shared_ptr<FlutterLaunchParams> launch_params = nullptr;
-  if (options.AppDesc() != "{}") {
-    app_desc = FlutterApplicationDescription::FromJsonString(options.AppDesc().c_str());
-  } else if (!options.BundlePath().empty()) {
-    app_desc = FlutterApplicationDescription::FromAppInfo(options.BundlePath().c_str());
+  {
+    TRACE_STARTUP_SCOPE("FlutterApplicationDescription");
+    if (options.AppDescJson()) {
+      app_desc = FlutterApplicationDescription::FromJsonValue(*options.AppDescJson());
+    } else if (options.AppDesc() != "{}") {
+      app_desc = FlutterApplicationDescription::FromJsonString(options.AppDesc());
+    } else if (!options.BundlePath().empty()) {
+      app_desc = FlutterApplicationDescription::FromAppInfo(
+          options.BundlePath().c_str(), AppDescriptorCacheDir(settings));
+      auto stats = FlutterApplicationDescription::GetCacheStats();
+      StartupTracer& tracer = StartupTracer::getInstance();
+      tracer.AddCounter("AppDescriptorCache.hits", stats.hits);
+      tracer.AddCounter("AppDescriptorCache.misses", stats.misses);
+      tracer.AddCounter("AppDescriptorCache.invalidations", stats.invalidations);
+    }
   }
-  if (options.Params() != "{}") {
-    launch_params = FlutterLaunchParams::FromJsonString(options.Params().c_str());
+  if (options.ParamsJson()) {
+    TRACE_STARTUP_SCOPE("FlutterLaunchParams");
+    launch_params = FlutterLaunchParams::FromJsonValue(*options.ParamsJson());
+  } else if (options.Params() != "{}") {
+    TRACE_STARTUP_SCOPE("FlutterLaunchParams");
+    launch_params = FlutterLaunchParams::FromJsonString(options.Params());
   }
   if (launch_params && app_desc) {
     app_desc->SetDisplayAffinity(launch_params->GetDisplayAffinity());
@@ -46,9 +119,6 @@ int main(int argc, char** argv) {
     }
   }
 
-  Settings& settings = Settings::getInstance();
-  settings.init();
-
   // Creates the Flutter project.
   std::string bundle_path;
   if (app_desc && !app_desc->BundlePath().empty()) {
@@ -79,13 +149,13 @@ int main(int argc, char** argv) {
   flutter::DartProject project(fl_path);
   auto command_line_arguments = std::vector<std::string>();
 
-  if (settings.getBool(FLUTTER_ALLOW_TAS)) {
+  if (settings.get<bool>(settings_key::kAllowTas)) {
     command_line_arguments.push_back("tas");
   } else {
     command_line_arguments.push_back("normal");
   }
   if (launch_params) {
-    command_line_arguments.push_back(options.Params());
+    command_line_arguments.emplace_back(options.Params());
   }
   project.set_dart_entrypoint_arguments(std::move(command_line_arguments));
 
@@ -164,19 +234,147 @@ int main(int argc, char** argv) {
 
   view_properties.keep_alive = options.IsKeepAlive();
 
-  settings.setEnv(*view_properties.app_id, bundle_path, assets_path);
-  settings.load(assets_path + "/version.json", false);
-  settings.set(FLUTTER_DISPLAY_BACKEND, options.DisplayBackend());
+  {
+    TRACE_STARTUP_SCOPE("Settings::setEnv");
+    settings.setEnv(*view_properties.app_id, bundle_path, assets_path);
+  }
+  {
+    TRACE_STARTUP_SCOPE("Settings::load(version.json)");
+    settings.load(assets_path + "/version.json", false);
+  }
+  settings.set(settings_key::kDisplayBackend, options.DisplayBackend());
+  if (settings.get<bool>(settings_key::kSettingsHotReload)) {
+    settings.startWatching();
+  }
+
+  // Another embedder would be loaded next to the zygote's one, with both
+  // exporting the same symbols. Start over without the zygote instead.
+  if (zygote &&
+      EmbedderLoader::GetFlutterRuntimePath() != zygote->embedder_path) {
+    LOG_INFO("Embedder %s is not the zygote's %s, relaunching",
+             EmbedderLoader::GetFlutterRuntimePath().c_str(),
+             zygote->embedder_path.c_str());
+    StartupTracer::getInstance().Flush();
+    // Log records still queued in this process would be lost with it.
+    logging::Flush();
+    execv("/proc/self/exe", const_cast<char* const*>(zygote->argv.data()));
+    LOG_ERROR("Failed to relaunch: %s", strerror(errno));
+    delete view_properties.webos_properties;
+    return 0;
+  }
 
   // The Flutter instance hosted by this window.
   FlutterWindow window(view_properties, project);
   if (!window.OnCreate(app_desc)) {
+    StartupTracer::getInstance().Flush();
     return 0;
   }
 
   window.Run();
+  StartupTracer::getInstance().Flush();
+  settings.stopWatching();
   window.OnDestroy();
 
   delete view_properties.webos_properties;
   return 0;
 }
+
+// Preloads what every launch needs and serves launch requests. Only returns
+// in forked children, or on a fatal error.
+int RunZygote(FlutterEmbedderOptions& options, int argc, char** argv) {
+  Settings& settings = Settings::getInstance();
+  settings.init();
+  StartupTracer::EnableFromSettings();
+  settings.setEnv();
+  settings.set(settings_key::kBundlePath, options.BundlePath());
+  settings.set(settings_key::kDisplayBackend, options.DisplayBackend());
+
+  // Kept loaded for the lifetime of the zygote. Children dlopen() the same
+  // paths again, which only takes a reference.
+  std::unique_ptr<EmbedderLoader> embedder;
+  std::unique_ptr<WebosInterfaceLoader> plugin_interface;
+  {
+    TRACE_STARTUP_SCOPE("Zygote preload");
+    embedder = std::make_unique<EmbedderLoader>();
+    plugin_interface = std::make_unique<WebosInterfaceLoader>();
+    // Compiled once here rather than in every child.
+    json_schema::LaunchParams();
+    json_schema::AppInfo();
+  }
+  const std::string embedder_path = EmbedderLoader::GetFlutterRuntimePath();
+
+  // The zygote's own arguments, e.g. --display and --bundle, are the
+  // defaults of every launch; the client's arguments follow and override
+  // them, as the last occurrence of an option wins.
+  const char* argv0 = argv[0];
+  const std::vector<std::string> zygote_args = LaunchArguments(argc, argv);
+
+  Zygote zygote(options.ZygoteSocket());
+  return zygote.Serve([argv0, &zygote_args,
+                       &embedder_path](const std::string& request) {
+    std::vector<std::string> args = zygote_args;
+    for (size_t begin = 0; begin < request.size();) {
+      size_t end = request.find('\0', begin);
+      if (end == std::string::npos)
+        end = request.size();
+      args.emplace_back(request, begin, end - begin);
+      begin = end + 1;
+    }
+
+    ZygoteChild child{embedder_path, {argv0}};
+    for (const std::string& arg : args)
+      child.argv.push_back(arg.c_str());
+    child.argv.push_back(nullptr);
+
+    FlutterEmbedderOptions child_options;
+    try {
+      if (!child_options.Parse(static_cast<int>(child.argv.size() - 1),
+                               const_cast<char**>(child.argv.data()))) {
+        return 0;
+      }
+    } catch (commandline::Exception& e) {
+      LOG_ERROR("e: %s", e.what());
+      return 0;
+    }
+    return RunApplication(child_options, &child);
+  });
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  FlutterEmbedderOptions options;
+  try {
+    TRACE_STARTUP_SCOPE("FlutterEmbedderOptions::Parse");
+    if (!options.Parse(argc, argv)) {
+      return 0;
+    }
+  } catch(commandline::Exception& e){
+     LOG_ERROR("e: %s", e.what());
+     return 0;
+  }
+
+  if (!options.ZygoteLaunch().empty()) {
+    // Hand the command line over to a running zygote, NUL-separated.
+    std::string request;
+    for (const std::string& arg : LaunchArguments(argc, argv)) {
+      if (!request.empty())
+        request.push_back('\0');
+      request += arg;
+    }
+    if (request.empty())
+      request = "{}";  // Requests must not be empty.
+    int pid = Zygote::Launch(options.ZygoteLaunch(), request);
+    if (pid < 0) {
+      return 1;
+    }
+    LOG_INFO("Launched by zygote: %d", pid);
+    return 0;
+  }
+
+  if (!options.ZygoteSocket().empty()) {
+    return RunZygote(options, argc, argv);
+  }
+
+  return RunApplication(options, nullptr);
+}
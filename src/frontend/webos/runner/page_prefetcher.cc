@@ -0,0 +1,243 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "page_prefetcher.h"
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+#include "logger.h"
+#include "runner_cache.h"
+#include "startup_tracer.h"
+
+using runner_cache::FileIdentity;
+
+namespace {
+
+constexpr uint64_t kPagemapPresent = 1ULL << 63;
+constexpr size_t kPagemapChunk = 512;
+// Gaps up to this many pages are read too, trading a little I/O for fewer
+// readahead() calls.
+constexpr uint64_t kMergeGapPages = 16;
+
+uint64_t PageSize() {
+  static const uint64_t page_size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  return page_size;
+}
+
+std::vector<std::pair<uint64_t, uint64_t>> ToRanges(std::vector<uint64_t> pages) {
+  std::sort(pages.begin(), pages.end());
+  pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+  std::vector<std::pair<uint64_t, uint64_t>> ranges;
+  for (uint64_t page : pages) {
+    if (!ranges.empty() &&
+        page <= ranges.back().first + ranges.back().second + kMergeGapPages) {
+      ranges.back().second = page - ranges.back().first + 1;
+    } else {
+      ranges.push_back({page, 1});
+    }
+  }
+  return ranges;
+}
+
+// Collects the file pages of |paths| that are mapped into this process.
+std::map<std::string, std::vector<uint64_t>> ReadMappedPages(
+    const std::vector<std::string>& paths) {
+  std::map<std::string, std::vector<uint64_t>> pages;
+
+  FILE* maps = fopen("/proc/self/maps", "r");
+  if (maps == NULL)
+    return pages;
+  int pagemap = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+  if (pagemap < 0) {
+    fclose(maps);
+    return pages;
+  }
+
+  const uint64_t page_size = PageSize();
+  char line[4096];
+  while (fgets(line, sizeof(line), maps)) {
+    uint64_t start, end, offset;
+    int path_pos = 0;
+    if (sscanf(line, "%" SCNx64 "-%" SCNx64 " %*s %" SCNx64 " %*s %*s %n",
+               &start, &end, &offset, &path_pos) != 3 || path_pos == 0)
+      continue;
+    std::string path(line + path_pos);
+    if (!path.empty() && path.back() == '\n')
+      path.pop_back();
+    if (std::find(paths.begin(), paths.end(), path) == paths.end())
+      continue;
+
+    std::vector<uint64_t>& file_pages = pages[path];
+    uint64_t entries[kPagemapChunk];
+    for (uint64_t va = start; va < end;) {
+      size_t count = std::min<uint64_t>(kPagemapChunk, (end - va) / page_size);
+      ssize_t read_size = pread(pagemap, entries, count * sizeof(uint64_t),
+                                (va / page_size) * sizeof(uint64_t));
+      if (read_size <= 0)
+        break;
+      count = static_cast<size_t>(read_size) / sizeof(uint64_t);
+      for (size_t i = 0; i < count; i++) {
+        if (entries[i] & kPagemapPresent)
+          file_pages.push_back(offset / page_size + (va - start) / page_size + i);
+      }
+      va += count * page_size;
+    }
+  }
+
+  close(pagemap);
+  fclose(maps);
+  return pages;
+}
+
+}  // namespace
+
+std::vector<std::string> PagePrefetcher::StartupFiles(
+    const std::string& bundle_path,
+    const std::string& embedder_path) {
+  return {
+    embedder_path,
+    bundle_path + "/lib/libapp.so",
+    bundle_path + "/data/icudtl.dat",
+  };
+}
+
+void PagePrefetcher::Start(const std::string& app_id,
+                           const std::vector<std::string>& paths) {
+  Join();
+  app_id_ = app_id;
+  paths_ = paths;
+  needs_profile_ = false;
+  recorded_ = false;
+
+  StartupTracer::getInstance().AddCounter("MajorFaults",
+                                          StartupTracer::Now().major_faults);
+  worker_ = std::thread([this]() {
+    TRACE_STARTUP_SCOPE("PagePrefetcher");
+    Prefetch();
+  });
+}
+
+void PagePrefetcher::Prefetch() {
+  std::vector<FileProfile> profile = ReadProfile();
+
+  for (const std::string& path : paths_) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      continue;
+
+    auto it = std::find_if(profile.begin(), profile.end(),
+                           [&path](const FileProfile& p) { return p.path == path; });
+    if (it != profile.end() &&
+        it->identity == FileIdentity::Of(path).ToString()) {
+      const uint64_t page_size = PageSize();
+      for (const auto& range : it->ranges)
+        readahead(fd, static_cast<off64_t>(range.first * page_size),
+                  range.second * page_size);
+    } else {
+      posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+      needs_profile_ = true;
+    }
+    close(fd);
+  }
+}
+
+void PagePrefetcher::Join() {
+  if (worker_.joinable())
+    worker_.join();
+}
+
+void PagePrefetcher::RecordProfile() {
+  if (recorded_)
+    return;
+  recorded_ = true;
+  Join();
+
+  StartupTracer::getInstance().AddCounter("MajorFaults",
+                                          StartupTracer::Now().major_faults);
+  if (!needs_profile_)
+    return;
+
+  TRACE_STARTUP_SCOPE("PagePrefetcher::RecordProfile");
+  // Files that were not mapped get an empty entry, so they are not read
+  // ahead again.
+  std::map<std::string, std::vector<uint64_t>> pages = ReadMappedPages(paths_);
+  std::vector<FileProfile> profile;
+  for (const std::string& path : paths_) {
+    FileIdentity identity = FileIdentity::Of(path);
+    if (!identity.Exists())
+      continue;
+    FileProfile file;
+    file.path = path;
+    file.identity = identity.ToString();
+    file.ranges = ToRanges(std::move(pages[path]));
+    profile.push_back(std::move(file));
+  }
+  WriteProfile(profile);
+}
+
+std::string PagePrefetcher::ProfilePath() const {
+  const std::string& dir = runner_cache::GetCacheDir();
+  if (dir.empty() || app_id_.empty() || app_id_.find('/') != std::string::npos)
+    return std::string();
+  return dir + "/prefetch-" + app_id_;
+}
+
+// One line per file: path \t identity \t first+count,first+count...
+std::vector<PagePrefetcher::FileProfile> PagePrefetcher::ReadProfile() const {
+  std::vector<FileProfile> profile;
+  std::string contents;
+  const std::string path = ProfilePath();
+  if (path.empty() || !runner_cache::ReadPrivateFile(path, &contents))
+    return profile;
+
+  std::istringstream stream(contents);
+  std::string line;
+  while (std::getline(stream, line)) {
+    std::istringstream fields(line);
+    FileProfile file;
+    std::string ranges;
+    if (!std::getline(fields, file.path, '\t') ||
+        !std::getline(fields, file.identity, '\t'))
+      continue;
+    std::getline(fields, ranges);
+
+    std::istringstream range_stream(ranges);
+    std::string range;
+    while (std::getline(range_stream, range, ',')) {
+      uint64_t first, count;
+      if (sscanf(range.c_str(), "%" SCNu64 "+%" SCNu64, &first, &count) == 2)
+        file.ranges.push_back({first, count});
+    }
+    profile.push_back(std::move(file));
+  }
+  return profile;
+}
+
+void PagePrefetcher::WriteProfile(const std::vector<FileProfile>& profile) const {
+  const std::string path = ProfilePath();
+  if (path.empty())
+    return;
+
+  std::string contents;
+  for (const FileProfile& file : profile) {
+    contents += file.path + "\t" + file.identity + "\t";
+    for (size_t i = 0; i < file.ranges.size(); i++) {
+      if (i)
+        contents += ",";
+      contents += std::to_string(file.ranges[i].first) + "+" +
+                  std::to_string(file.ranges[i].second);
+    }
+    contents += "\n";
+  }
+  if (!runner_cache::WriteFileAtomically(path, contents.data(), contents.size()))
+    LOG_WARNING("Failed to write prefetch profile %s", path.c_str());
+}
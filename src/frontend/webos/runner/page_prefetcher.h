@@ -0,0 +1,65 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_RUNNER_PAGE_PREFETCHER_H_
+#define FLUTTER_RUNNER_PAGE_PREFETCHER_H_
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Warms the page cache for the files a cold start faults in the most: the
+// embedder, the AOT library and the ICU data.
+//
+// Start() reads them ahead on a helper thread. Without a profile the whole
+// files are hinted with POSIX_FADV_WILLNEED, and RecordProfile(), called
+// once the first frame is out, stores which of their pages this process has
+// mapped in runner_cache::GetCacheDir()/prefetch-<appId>. Later launches
+// then only read that working set, until one of the files changes.
+class PagePrefetcher {
+ private:
+  PagePrefetcher() {}
+  virtual ~PagePrefetcher() { Join(); }
+
+ public:
+  static PagePrefetcher& getInstance()
+  {
+    static PagePrefetcher instance;
+    return instance;
+  }
+
+  // Paths of the embedder, libapp.so and icudtl.dat under |bundle_path|.
+  static std::vector<std::string> StartupFiles(const std::string& bundle_path,
+                                               const std::string& embedder_path);
+
+  // Must not be called while a previous prefetch is still pending.
+  void Start(const std::string& app_id, const std::vector<std::string>& paths);
+
+  // Records the major fault count into the startup trace and, if there was
+  // no valid profile, the pages touched so far. Later calls are no-ops.
+  void RecordProfile();
+
+ private:
+  struct FileProfile {
+    std::string path;
+    std::string identity;
+    // Sorted [first page, page count) ranges.
+    std::vector<std::pair<uint64_t, uint64_t>> ranges;
+  };
+
+  void Prefetch();
+  void Join();
+  std::string ProfilePath() const;
+  std::vector<FileProfile> ReadProfile() const;
+  void WriteProfile(const std::vector<FileProfile>& profile) const;
+
+  std::thread worker_;
+  std::string app_id_;
+  std::vector<std::string> paths_;
+  bool needs_profile_ = false;
+  bool recorded_ = true;
+};
+
+#endif  // FLUTTER_RUNNER_PAGE_PREFETCHER_H_
@@ -0,0 +1,132 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "runner_cache.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cinttypes>
+
+#include "logger.h"
+
+namespace runner_cache {
+
+namespace {
+
+std::string DefaultCacheDir() {
+  const char* runtime_dir = getenv("XDG_RUNTIME_DIR");
+  if (runtime_dir && *runtime_dir)
+    return std::string(runtime_dir) + "/flutter-runner";
+  return "/tmp/flutter-runner-" + std::to_string(geteuid());
+}
+
+bool ReadFd(int fd, std::string* contents) {
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+    return false;
+  contents->resize(static_cast<size_t>(st.st_size));
+  ssize_t read_size = read(fd, &(*contents)[0], contents->size());
+  return read_size == static_cast<ssize_t>(contents->size());
+}
+
+}  // namespace
+
+FileIdentity FileIdentity::Of(const std::string& path) {
+  FileIdentity identity;
+  struct stat st;
+  if (stat(path.c_str(), &st) == 0) {
+    identity.dev = static_cast<uint64_t>(st.st_dev);
+    identity.ino = static_cast<uint64_t>(st.st_ino);
+    identity.mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 +
+                        st.st_mtim.tv_nsec;
+    identity.size = static_cast<int64_t>(st.st_size);
+  }
+  return identity;
+}
+
+std::string FileIdentity::ToString() const {
+  char buf[96];
+  snprintf(buf, sizeof(buf), "%" PRIu64 ":%" PRIu64 ":%" PRId64 ":%" PRId64,
+           dev, ino, mtime_ns, size);
+  return buf;
+}
+
+bool FileIdentity::FromString(const std::string& str, FileIdentity* identity) {
+  return sscanf(str.c_str(), "%" SCNu64 ":%" SCNu64 ":%" SCNd64 ":%" SCNd64,
+                &identity->dev, &identity->ino, &identity->mtime_ns,
+                &identity->size) == 4;
+}
+
+const std::string& GetCacheDir() {
+  static const std::string dir = []() {
+    const char* env = getenv("FLUTTER_RUNNER_CACHE_DIR");
+    std::string path = (env && *env) ? env : DefaultCacheDir();
+    if (mkdir(path.c_str(), 0700) < 0 && errno != EEXIST)
+      return std::string();
+    if (!IsPrivateDirectory(path)) {
+      LOG_WARNING("Ignoring runner cache %s: not a private directory",
+                  path.c_str());
+      return std::string();
+    }
+    return path;
+  }();
+  return dir;
+}
+
+bool IsPrivateDirectory(const std::string& path) {
+  struct stat st;
+  return lstat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode) &&
+         st.st_uid == geteuid() && (st.st_mode & 077) == 0;
+}
+
+bool IsPrivateFile(int fd) {
+  struct stat st;
+  return fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+         st.st_uid == geteuid() && (st.st_mode & 077) == 0;
+}
+
+bool ReadFile(const std::string& path, std::string* contents) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+
+  bool ok = ReadFd(fd, contents);
+  close(fd);
+  return ok;
+}
+
+bool ReadPrivateFile(const std::string& path, std::string* contents) {
+  int fd = open(path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+
+  bool ok = IsPrivateFile(fd) && ReadFd(fd, contents);
+  close(fd);
+  return ok;
+}
+
+bool WriteFileAtomically(const std::string& path,
+                         const void* data,
+                         size_t size) {
+  std::string temp_path = path + ".XXXXXX";
+  int fd = mkostemp(&temp_path[0], O_CLOEXEC);
+  if (fd < 0)
+    return false;
+
+  bool ok = write(fd, data, size) == static_cast<ssize_t>(size);
+  ok = (close(fd) == 0) && ok;
+  if (ok)
+    ok = rename(temp_path.c_str(), path.c_str()) == 0;
+  if (!ok)
+    unlink(temp_path.c_str());
+  return ok;
+}
+
+}  // namespace runner_cache
@@ -0,0 +1,78 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_RUNNER_RUNNER_CACHE_H_
+#define FLUTTER_RUNNER_RUNNER_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Helpers shared by the on-disk caches of the runner.
+namespace runner_cache {
+
+// Identity of a file used to invalidate cached data derived from it.
+struct FileIdentity {
+  uint64_t dev = 0;
+  uint64_t ino = 0;
+  int64_t mtime_ns = 0;
+  int64_t size = -1;  // -1 when the file does not exist
+
+  static FileIdentity Of(const std::string& path);
+
+  bool Exists() const { return size >= 0; }
+  bool operator==(const FileIdentity& other) const {
+    return dev == other.dev && ino == other.ino &&
+           mtime_ns == other.mtime_ns && size == other.size;
+  }
+  bool operator!=(const FileIdentity& other) const {
+    return !(*this == other);
+  }
+
+  std::string ToString() const;
+  static bool FromString(const std::string& str, FileIdentity* identity);
+};
+
+// Directory holding the runner caches: $FLUTTER_RUNNER_CACHE_DIR, else
+// $XDG_RUNTIME_DIR/flutter-runner, else /tmp/flutter-runner-<euid>. It does
+// not depend on Settings since some caches are read before the configs are
+// loaded. Created on first use. Empty, disabling the caches, unless it
+// passes IsPrivateDirectory().
+const std::string& GetCacheDir();
+
+// Whether |path| is a directory, not a symlink, owned by the effective user
+// and closed to everyone else. Cached data is only trusted from such a
+// directory, since another user could otherwise plant it.
+bool IsPrivateDirectory(const std::string& path);
+
+// Whether |fd| is a regular file owned by the effective user and closed to
+// everyone else.
+bool IsPrivateFile(int fd);
+
+bool ReadFile(const std::string& path, std::string* contents);
+
+// ReadFile() for cache files: fails on symlinks and on files that do not
+// pass IsPrivateFile().
+bool ReadPrivateFile(const std::string& path, std::string* contents);
+
+// Writes through a temporary file and rename(), so concurrent launches never
+// observe a partially written cache. The temporary file is created
+// exclusively with mode 0600.
+bool WriteFileAtomically(const std::string& path,
+                         const void* data,
+                         size_t size);
+
+// FNV-1a, used for cache keys and content hashes.
+constexpr uint64_t Hash(const char* data, size_t size,
+                        uint64_t hash = 14695981039346656037ULL) {
+  for (size_t i = 0; i < size; i++) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+}  // namespace runner_cache
+
+#endif  // FLUTTER_RUNNER_RUNNER_CACHE_H_
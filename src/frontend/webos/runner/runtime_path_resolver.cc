@@ -0,0 +1,189 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "runtime_path_resolver.h"
+
+#include <elf.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sstream>
+
+#include "logger.h"
+#include "runner_cache.h"
+
+using runner_cache::FileIdentity;
+
+namespace {
+
+constexpr char kCacheFileName[] = "/runtime-paths";
+constexpr size_t kMaxCacheEntries = 64;
+
+// e_ident, e_type and e_machine are at the same offsets in the 32 and 64-bit
+// headers.
+constexpr size_t kElfHeaderPrefix = EI_NIDENT + 2 * sizeof(uint16_t);
+
+bool ReadElfHeaderPrefix(const char* path, unsigned char* header) {
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+  bool ok = read(fd, header, kElfHeaderPrefix) ==
+            static_cast<ssize_t>(kElfHeaderPrefix);
+  close(fd);
+  return ok && memcmp(header, ELFMAG, SELFMAG) == 0;
+}
+
+uint16_t ElfField(const unsigned char* header, size_t offset) {
+  uint16_t value;
+  memcpy(&value, header + offset, sizeof(value));
+  return value;
+}
+
+std::string DirName(const std::string& path) {
+  std::string::size_type pos = path.rfind('/');
+  if (pos == std::string::npos)
+    return ".";
+  return pos == 0 ? "/" : path.substr(0, pos);
+}
+
+std::string CachePath() {
+  const std::string& dir = runner_cache::GetCacheDir();
+  return dir.empty() ? std::string() : dir + kCacheFileName;
+}
+
+// One line per key:
+//   key \t index { \t candidate \t identity \t dir identity }[0..index]
+// Every candidate up to the resolved |index| is recorded, so a library
+// appearing at a higher-priority location invalidates the entry.
+std::string FormatEntry(const std::string& key,
+                        const std::vector<std::string>& candidates,
+                        size_t index) {
+  std::string line = key + "\t" + std::to_string(index);
+  for (size_t i = 0; i <= index; i++) {
+    line += "\t" + candidates[i];
+    line += "\t" + FileIdentity::Of(candidates[i]).ToString();
+    line += "\t" + FileIdentity::Of(DirName(candidates[i])).ToString();
+  }
+  return line;
+}
+
+// Returns the cached index if the entry still describes the filesystem.
+bool ValidateEntry(const std::string& line,
+                   const std::vector<std::string>& candidates,
+                   size_t* index) {
+  std::vector<std::string> fields;
+  std::istringstream stream(line);
+  std::string field;
+  while (std::getline(stream, field, '\t'))
+    fields.push_back(field);
+
+  if (fields.size() < 2)
+    return false;
+  char* end = nullptr;
+  unsigned long cached = strtoul(fields[1].c_str(), &end, 10);
+  if (*end != '\0' || cached >= candidates.size() ||
+      fields.size() != 2 + 3 * (cached + 1))
+    return false;
+
+  for (size_t i = 0; i <= cached; i++) {
+    const std::string* entry = &fields[2 + 3 * i];
+    FileIdentity file;
+    FileIdentity dir;
+    if (entry[0] != candidates[i] ||
+        !FileIdentity::FromString(entry[1], &file) ||
+        !FileIdentity::FromString(entry[2], &dir))
+      return false;
+    if (FileIdentity::Of(candidates[i]) != file)
+      return false;
+    // A missing candidate is only known to be still missing while its
+    // directory is unchanged.
+    if (i < cached && FileIdentity::Of(DirName(candidates[i])) != dir)
+      return false;
+  }
+  *index = cached;
+  return true;
+}
+
+void StoreEntry(const std::string& cache_path,
+                const std::string& contents,
+                const std::string& key,
+                const std::string& entry) {
+  std::vector<std::string> lines;
+  std::istringstream stream(contents);
+  std::string line;
+  while (std::getline(stream, line)) {
+    if (line.compare(0, key.size() + 1, key + "\t") != 0)
+      lines.push_back(line);
+  }
+  if (lines.size() >= kMaxCacheEntries)
+    lines.erase(lines.begin(), lines.end() - (kMaxCacheEntries - 1));
+  lines.push_back(entry);
+
+  std::string updated;
+  for (const std::string& l : lines)
+    updated += l + "\n";
+  if (!runner_cache::WriteFileAtomically(cache_path, updated.data(),
+                                         updated.size()))
+    LOG_WARNING("Failed to write %s", cache_path.c_str());
+}
+
+}  // namespace
+
+std::string RuntimePathResolver::Resolve(
+    const std::string& key,
+    const std::vector<std::string>& candidates) {
+  if (candidates.empty())
+    return std::string();
+
+  const std::string cache_path = CachePath();
+  std::string contents;
+  if (!cache_path.empty() && runner_cache::ReadPrivateFile(cache_path, &contents)) {
+    std::istringstream stream(contents);
+    std::string line;
+    while (std::getline(stream, line)) {
+      if (line.compare(0, key.size() + 1, key + "\t") != 0)
+        continue;
+      size_t index;
+      if (ValidateEntry(line, candidates, &index))
+        return candidates[index];
+      break;
+    }
+  }
+
+  for (size_t i = 0; i < candidates.size(); i++) {
+    if (!IsLoadableElf(candidates[i])) {
+      LOG_DEBUG("Skipping runtime candidate %s", candidates[i].c_str());
+      continue;
+    }
+    if (!cache_path.empty())
+      StoreEntry(cache_path, contents, key, FormatEntry(key, candidates, i));
+    return candidates[i];
+  }
+
+  LOG_WARNING("No loadable runtime library for %s", key.c_str());
+  return candidates.back();
+}
+
+bool RuntimePathResolver::IsLoadableElf(const std::string& path) {
+  static const uint16_t self_machine = []() -> uint16_t {
+    unsigned char header[kElfHeaderPrefix];
+    if (!ReadElfHeaderPrefix("/proc/self/exe", header))
+      return EM_NONE;
+    return ElfField(header, EI_NIDENT + sizeof(uint16_t));
+  }();
+
+  unsigned char header[kElfHeaderPrefix];
+  if (!ReadElfHeaderPrefix(path.c_str(), header))
+    return false;
+
+  const unsigned char elf_class =
+      sizeof(void*) == 8 ? ELFCLASS64 : ELFCLASS32;
+  if (header[EI_CLASS] != elf_class)
+    return false;
+  if (ElfField(header, EI_NIDENT) != ET_DYN)
+    return false;
+  return self_machine == EM_NONE ||
+         ElfField(header, EI_NIDENT + sizeof(uint16_t)) == self_machine;
+}
@@ -0,0 +1,30 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_RUNNER_RUNTIME_PATH_RESOLVER_H_
+#define FLUTTER_RUNNER_RUNTIME_PATH_RESOLVER_H_
+
+#include <string>
+#include <vector>
+
+// Picks the first loadable shared library out of an ordered candidate list
+// and remembers the choice in runner_cache::GetCacheDir()/runtime-paths.
+//
+// A cached entry is reused only while the resolved file and every
+// higher-priority candidate, along with its directory, have the same
+// inode/mtime/size as when it was written, so installing or removing a
+// library anywhere on the search path falls back to probing again.
+class RuntimePathResolver {
+ public:
+  // |key| identifies the lookup, e.g. app id, framework version and backend.
+  // Returns the last candidate if none is loadable, so that the dlopen()
+  // error names the system path as before.
+  static std::string Resolve(const std::string& key,
+                             const std::vector<std::string>& candidates);
+
+  // True if |path| is an ELF shared object for the machine of this process.
+  static bool IsLoadableElf(const std::string& path);
+};
+
+#endif  // FLUTTER_RUNNER_RUNTIME_PATH_RESOLVER_H_
@@ -3,73 +3,520 @@
 // found in the LICENSE file.
 
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <string>
 #include <cstdlib>
+#include <iterator>
+#include <set>
 
-#include "rapidjson/filereadstream.h"
 #include "rapidjson/document.h"
 #include "rapidjson/writer.h"
 
 #include "flutter_embedder_loader.h"
 #include "logger.h"
+#include "runner_cache.h"
 #include "settings.h"
 #include "settings_conf.h"   //generated from cmake
 
 using namespace rapidjson;
 
+namespace {
+
+constexpr size_t kInitialIndexSlots = 64;
+// Editors write conf files in several steps; wait for the burst to end.
+constexpr int kReloadDebounceMs = 100;
+
+uint64_t HashKey(std::string_view key) {
+  return runner_cache::Hash(key.data(), key.size());
+}
+
+// Compiled form of one conf file, so later loads skip the JSON parse:
+//   SnapshotHeader, SnapshotRecord[count], string blob
+// Valid only for the exact source file it was compiled from, which is
+// checked by dev/inode/mtime/size and a hash of its contents, and only when
+// kept in the verified runner_cache::GetCacheDir() as a private file.
+constexpr char kSnapshotMagic[8] = {'F', 'L', 'S', 'N', 'A', 'P', '0', '1'};
+
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t count;
+  uint32_t blob_size;
+  uint64_t dev;
+  uint64_t ino;
+  int64_t mtime_ns;
+  int64_t size;
+  uint64_t content_hash;
+};
+
+struct SnapshotRecord {
+  uint32_t key_offset;
+  uint32_t key_length;
+  uint32_t text_offset;
+  uint32_t text_length;
+  int64_t int_value;
+  double double_value;
+  uint8_t type;
+  uint8_t bool_value;
+  uint8_t reserved[6];
+};
+
+class SnapshotFile {
+ public:
+  SnapshotFile() {}
+  ~SnapshotFile() {
+    if (m_data)
+      munmap(m_data, m_size);
+  }
+
+  // Prevent copying.
+  SnapshotFile(SnapshotFile const&) = delete;
+  SnapshotFile& operator=(SnapshotFile const&) = delete;
+
+  bool Open(const std::string& path,
+            const runner_cache::FileIdentity& source,
+            uint64_t content_hash) {
+    int fd = open(path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0)
+      return false;
+    // The header proves the snapshot matches the conf, not who wrote it:
+    // only trust snapshots the user wrote and nobody else can replace.
+    struct stat st;
+    if (runner_cache::IsPrivateFile(fd) && fstat(fd, &st) == 0 &&
+        static_cast<size_t>(st.st_size) >= sizeof(SnapshotHeader)) {
+      m_size = static_cast<size_t>(st.st_size);
+      void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      m_data = (data == MAP_FAILED) ? nullptr : data;
+    }
+    close(fd);
+    if (!m_data)
+      return false;
+
+    const SnapshotHeader* header = static_cast<const SnapshotHeader*>(m_data);
+    if (memcmp(header->magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+        header->dev != source.dev || header->ino != source.ino ||
+        header->mtime_ns != source.mtime_ns || header->size != source.size ||
+        header->content_hash != content_hash)
+      return false;
+
+    const size_t records_size = header->count * sizeof(SnapshotRecord);
+    if (m_size != sizeof(SnapshotHeader) + records_size + header->blob_size)
+      return false;
+
+    m_records = reinterpret_cast<const SnapshotRecord*>(header + 1);
+    m_blob = reinterpret_cast<const char*>(m_records + header->count);
+    for (uint32_t i = 0; i < header->count; i++) {
+      const SnapshotRecord& r = m_records[i];
+      if (r.key_offset + static_cast<uint64_t>(r.key_length) > header->blob_size ||
+          r.text_offset + static_cast<uint64_t>(r.text_length) > header->blob_size ||
+          r.type > static_cast<uint8_t>(Settings::Type::kJson))
+        return false;
+    }
+    m_count = header->count;
+    return true;
+  }
+
+  uint32_t Count() const { return m_count; }
+  const SnapshotRecord& Record(uint32_t i) const { return m_records[i]; }
+  std::string_view String(uint32_t offset, uint32_t length) const {
+    return std::string_view(m_blob + offset, length);
+  }
+
+  static bool Write(const std::string& path,
+                    const runner_cache::FileIdentity& source,
+                    uint64_t content_hash,
+                    const std::vector<std::pair<std::string_view,
+                                                const Settings::Value*>>& values) {
+    std::string blob;
+    std::vector<SnapshotRecord> records;
+    for (const auto& kv : values) {
+      SnapshotRecord r = {};
+      r.key_offset = static_cast<uint32_t>(blob.size());
+      r.key_length = static_cast<uint32_t>(kv.first.size());
+      blob.append(kv.first.data(), kv.first.size());
+      r.text_offset = static_cast<uint32_t>(blob.size());
+      r.text_length = static_cast<uint32_t>(kv.second->text.size());
+      blob += kv.second->text;
+      r.int_value = kv.second->int_value;
+      r.double_value = kv.second->double_value;
+      r.type = static_cast<uint8_t>(kv.second->type);
+      r.bool_value = kv.second->bool_value;
+      records.push_back(r);
+    }
+
+    SnapshotHeader header = {};
+    memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.count = static_cast<uint32_t>(records.size());
+    header.blob_size = static_cast<uint32_t>(blob.size());
+    header.dev = source.dev;
+    header.ino = source.ino;
+    header.mtime_ns = source.mtime_ns;
+    header.size = source.size;
+    header.content_hash = content_hash;
+
+    std::string image(reinterpret_cast<const char*>(&header), sizeof(header));
+    image.append(reinterpret_cast<const char*>(records.data()),
+                 records.size() * sizeof(SnapshotRecord));
+    image += blob;
+    return runner_cache::WriteFileAtomically(path, image.data(), image.size());
+  }
+
+ private:
+  void* m_data = nullptr;
+  size_t m_size = 0;
+  const SnapshotRecord* m_records = nullptr;
+  const char* m_blob = nullptr;
+  uint32_t m_count = 0;
+};
+
+std::string SnapshotPath(const std::string& conf_path) {
+  const std::string& dir = runner_cache::GetCacheDir();
+  if (dir.empty())
+    return std::string();
+  char name[32];
+  snprintf(name, sizeof(name), "/settings-%016llx.snap",
+           static_cast<unsigned long long>(HashKey(conf_path)));
+  return dir + name;
+}
+
+}  // namespace
+
+Settings::Settings()
+{
+  std::unique_ptr<Table> table = newTable();
+  m_table.store(table.get(), std::memory_order_release);
+  m_tables.push_back(std::move(table));
+}
+
+Settings::~Settings()
+{
+  stopWatching();
+}
+
+std::unique_ptr<Settings::Table> Settings::newTable()
+{
+  std::unique_ptr<Table> table = std::make_unique<Table>();
+  table->entries.resize(settings_key::kWellKnownCount);
+  table->index.assign(kInitialIndexSlots, kEmptySlot);
+  for (unsigned id = 0; id < settings_key::kWellKnownCount; id++) {
+    std::string_view name = settings_key::kNames[id];
+    table->entries[id].name = std::string(name);
+    table->entries[id].hash = HashKey(name);
+
+    size_t mask = table->index.size() - 1;
+    size_t slot = table->entries[id].hash & mask;
+    while (table->index[slot] != kEmptySlot)
+      slot = (slot + 1) & mask;
+    table->index[slot] = id;
+  }
+  return table;
+}
+
+std::unique_ptr<Settings::Table> Settings::beginWrite() const
+{
+  return std::make_unique<Table>(table());
+}
+
+void Settings::publish(std::unique_ptr<Table> table)
+{
+  table->generation = this->table().generation + 1;
+  m_table.store(table.get(), std::memory_order_release);
+  m_tables.push_back(std::move(table));
+  if (m_tables.size() > kRetainedTables)
+    m_tables.erase(m_tables.begin());
+}
+
 void Settings::init()
 {
   load(kSettingsFile, true);
 }
 
+bool Settings::load(std::string const & conf_path, bool isExport)
+{
+  std::lock_guard<std::mutex> lock(m_writeMutex);
+  std::unique_ptr<Table> table = beginWrite();
+  bool loaded = loadConf(*table, conf_path, isExport);
+  // Recorded even if missing, so that a conf file created later is seen.
+  m_journal.push_back({true, conf_path, std::string()});
+  publish(std::move(table));
+  m_env.Commit();
+  return loaded;
+}
+
+void Settings::set(settings_key::Id key, std::string_view value)
+{
+  set(settings_key::kNames[key], value);
+}
+
+void Settings::set(std::string_view key, std::string_view value)
+{
+  std::lock_guard<std::mutex> lock(m_writeMutex);
+  std::unique_ptr<Table> table = beginWrite();
+  store(table->intern(key), value);
+  // A set of the same key since the last load is overridden, drop it so
+  // that repeated sets do not grow the journal.
+  for (auto it = m_journal.rbegin(); it != m_journal.rend() && !it->is_load;
+       ++it) {
+    if (it->key == key) {
+      m_journal.erase(std::next(it).base());
+      break;
+    }
+  }
+  m_journal.push_back({false, std::string(key), std::string(value)});
+  publish(std::move(table));
+}
+
 void Settings::setEnv(std::string const & app_id,
                       std::string const & bundle_path,
                       std::string const & assets_path)
 {
+  std::lock_guard<std::mutex> lock(m_writeMutex);
+  std::unique_ptr<Table> table = beginWrite();
+  auto setLocked = [this, &table](settings_key::Id key, std::string_view value) {
+    store(table->entries[key].value, value);
+    m_journal.push_back({false, settings_key::kNames[key], std::string(value)});
+  };
+
   if (!app_id.empty())
   {
-    setenv(FLUTTER_APP_ID, app_id.c_str(), 0);
-    m_settings[FLUTTER_APP_ID] = app_id;
+    m_env.Add(FLUTTER_APP_ID, app_id);
+    setLocked(settings_key::kAppId, app_id);
   }
 
   if (!bundle_path.empty())
   {
-    setenv(FLUTTER_BUNDLE_PATH, bundle_path.c_str(),0);
-    m_settings[FLUTTER_BUNDLE_PATH] = bundle_path;
+    m_env.Add(FLUTTER_BUNDLE_PATH, bundle_path);
+    setLocked(settings_key::kBundlePath, bundle_path);
 
     std::string local_conf_file = bundle_path + "/" + FLUTTER_CONF_FILE;
-    load(local_conf_file.c_str(), true);
+    loadConf(*table, local_conf_file, true);
+    m_journal.push_back({true, local_conf_file, std::string()});
   }
 
   if (!assets_path.empty())
   {
-    setenv(FLUTTER_ASSETS_PATH, assets_path.c_str(),0);
-    m_settings[FLUTTER_ASSETS_PATH] = assets_path;
+    m_env.Add(FLUTTER_ASSETS_PATH, assets_path);
+    setLocked(settings_key::kAssetsPath, assets_path);
   }
 
 
-  m_settings[FLUTTER_RUNTIME_MODE] = "release";
-  m_settings[FLUTTER_FRAMEWORK_VERSION] = "latest";
+  setLocked(settings_key::kRuntimeMode, FLUTTER_DEFAULT_RUNTIME_MODE);
+  setLocked(settings_key::kFrameworkVersion, FLUTTER_DEFAULT_FRAMEWORK_VERSION);
+
+  publish(std::move(table));
+  m_env.Commit();
 }
 
-bool Settings::load(std::string const & conf_path, bool isExport)
+void Settings::reload()
+{
+  std::vector<std::string> changed;
+  {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    std::unique_ptr<Table> table = newTable();
+    for (const JournalEntry& entry : m_journal) {
+      if (entry.is_load)
+        loadConf(*table, entry.key, false);
+      else
+        store(table->intern(entry.key), entry.value);
+    }
+
+    changed = diff(this->table(), *table);
+    if (changed.empty())
+      return;
+    publish(std::move(table));
+  }
+
+  LOG_INFO("Settings reloaded, %zu keys changed", changed.size());
+  notify(changed);
+}
+
+std::vector<std::string> Settings::diff(const Table& from, const Table& to)
+{
+  std::vector<std::string> keys;
+  for (const Entry& entry : to.entries) {
+    const Value& old = from.find(entry.name);
+    if (old.type != entry.value.type || old.text != entry.value.text)
+      keys.push_back(entry.name);
+  }
+  for (const Entry& entry : from.entries) {
+    if (entry.value.type != Type::kNull &&
+        to.find(entry.name).type == Type::kNull)
+      keys.push_back(entry.name);
+  }
+  return keys;
+}
+
+bool Settings::startWatching()
+{
+  std::set<std::string> paths;
+  {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    if (m_watcher.joinable())
+      return true;
+    for (const JournalEntry& entry : m_journal) {
+      if (entry.is_load)
+        paths.insert(entry.key);
+    }
+  }
+
+  int inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotify_fd < 0) {
+    LOG_WARNING("inotify_init1 failed: %s", strerror(errno));
+    return false;
+  }
+
+  // Directories are watched rather than the files, since editors and
+  // package managers replace files by renaming over them.
+  std::set<std::string> dirs;
+  for (const std::string& path : paths) {
+    std::string::size_type pos = path.rfind('/');
+    dirs.insert(pos == std::string::npos ? std::string(".") : path.substr(0, pos));
+  }
+  for (const std::string& dir : dirs) {
+    if (inotify_add_watch(inotify_fd, dir.c_str(),
+                          IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE) < 0)
+      LOG_WARNING("Cannot watch %s: %s", dir.c_str(), strerror(errno));
+  }
+
+  m_stopFd = eventfd(0, EFD_CLOEXEC);
+  if (m_stopFd < 0) {
+    close(inotify_fd);
+    return false;
+  }
+
+  m_watcher = std::thread(&Settings::watch, this, inotify_fd, m_stopFd,
+                          std::vector<std::string>(paths.begin(), paths.end()));
+  return true;
+}
+
+void Settings::stopWatching()
+{
+  if (!m_watcher.joinable())
+    return;
+
+  uint64_t one = 1;
+  if (write(m_stopFd, &one, sizeof(one)) < 0)
+    LOG_WARNING("Failed to stop the settings watcher");
+  m_watcher.join();
+  close(m_stopFd);
+  m_stopFd = -1;
+}
+
+void Settings::watch(int inotify_fd, int stop_fd, std::vector<std::string> paths)
+{
+  // Directory watch descriptors are shared by the files in it, so match on
+  // the file names only.
+  std::set<std::string> names;
+  for (const std::string& path : paths) {
+    std::string::size_type pos = path.rfind('/');
+    names.insert(pos == std::string::npos ? path : path.substr(pos + 1));
+  }
+
+  bool pending = false;
+  alignas(struct inotify_event) char buffer[4096];
+  for (;;) {
+    struct pollfd fds[2] = {{inotify_fd, POLLIN, 0}, {stop_fd, POLLIN, 0}};
+    int ready = poll(fds, 2, pending ? kReloadDebounceMs : -1);
+    if (ready < 0 && errno != EINTR)
+      break;
+    if (fds[1].revents)
+      break;
+
+    if (ready == 0 && pending) {
+      pending = false;
+      reload();
+      continue;
+    }
+
+    ssize_t size;
+    while ((size = read(inotify_fd, buffer, sizeof(buffer))) > 0) {
+      for (char* p = buffer; p < buffer + size;) {
+        const struct inotify_event* event =
+            reinterpret_cast<const struct inotify_event*>(p);
+        if (event->len && names.count(event->name))
+          pending = true;
+        p += sizeof(struct inotify_event) + event->len;
+      }
+    }
+  }
+  close(inotify_fd);
+}
+
+int Settings::subscribe(Listener listener)
+{
+  std::lock_guard<std::mutex> lock(m_listenerMutex);
+  int id = m_nextListenerId++;
+  m_listeners.push_back({id, std::move(listener)});
+  return id;
+}
+
+void Settings::unsubscribe(int id)
+{
+  std::lock_guard<std::mutex> lock(m_listenerMutex);
+  for (auto it = m_listeners.begin(); it != m_listeners.end(); ++it) {
+    if (it->first == id) {
+      m_listeners.erase(it);
+      return;
+    }
+  }
+}
+
+void Settings::notify(const std::vector<std::string>& keys)
+{
+  std::vector<std::pair<int, Listener>> listeners;
+  {
+    std::lock_guard<std::mutex> lock(m_listenerMutex);
+    listeners = m_listeners;
+  }
+  for (auto& listener : listeners)
+    listener.second(keys);
+}
+
+bool Settings::loadConf(Table& table,
+                        std::string const & conf_path,
+                        bool isExport)
 {
   if (conf_path.empty()) return false;
 
   LOG_INFO("LoadConf : %s", conf_path.c_str());
-  FILE* fp = fopen(conf_path.c_str(), "r");
-
-  if (fp == NULL) {
+  const runner_cache::FileIdentity source = runner_cache::FileIdentity::Of(conf_path);
+  std::string json;
+  if (!runner_cache::ReadFile(conf_path, &json)) {
     LOG_WARNING("Failed to load conf file");
     return false;
   }
 
-  char readBuffer[65536];
-  FileReadStream is(fp, readBuffer, sizeof(readBuffer));
+  const uint64_t content_hash = runner_cache::Hash(json.data(), json.size());
+  const std::string snapshot_path = SnapshotPath(conf_path);
+  if (!snapshot_path.empty()) {
+    SnapshotFile snapshot;
+    if (snapshot.Open(snapshot_path, source, content_hash)) {
+      for (uint32_t i = 0; i < snapshot.Count(); i++) {
+        const SnapshotRecord& r = snapshot.Record(i);
+        Settings::Value& value = table.intern(snapshot.String(r.key_offset, r.key_length));
+        std::string_view text = snapshot.String(r.text_offset, r.text_length);
+        value.type = static_cast<Type>(r.type);
+        value.bool_value = r.bool_value;
+        value.int_value = r.int_value;
+        value.double_value = r.double_value;
+        value.text.assign(text.data(), text.size());
+
+        if (isExport)
+          m_env.Add(snapshot.String(r.key_offset, r.key_length), value.text);
+      }
+      return true;
+    }
+  }
 
   Document doc;
-  doc.ParseStream(is);
+  doc.Parse(json.c_str(), json.size());
 
   if (doc.HasParseError()) {
     LOG_ERROR("Invalid JSON-format parse error");
@@ -81,57 +528,148 @@ bool Settings::load(std::string const & conf_path, bool isExport)
     return false;
   }
 
-  std::string param;
-  std::string value;
-  bool has_value;
-
+  std::vector<std::string_view> loaded;
   for (auto&m : doc.GetObject()) {
-    param = m.name.GetString();
-    has_value = !m.value.IsNull();
-    if (!param.empty() && has_value) {
-      Value& v = m.value;
-      if (v.IsString()) {
-        value = v.GetString();
-      } else if (v.IsBool()) {
-        value = v.GetBool() ? "true" : "false";
-      } else if (v.IsInt()) {
-        value = std::to_string(v.GetInt());
-      } else if (v.IsObject()) {
-        StringBuffer strbuf(0, 1024); //allocate 1024byte, default 512bytes
-        Writer<StringBuffer> writer(strbuf);
-        v.Accept(writer);
-        value = strbuf.GetString();
-      }
-
-      if (isExport)
-        setenv(param.c_str(),value.c_str(), 0);
+    std::string_view param(m.name.GetString(), m.name.GetStringLength());
+    const rapidjson::Value& v = m.value;
+    if (param.empty() || v.IsNull())
+      continue;
 
-      m_settings[param] = value;
+    Settings::Value& value = table.intern(param);
+    if (v.IsString()) {
+      store(value, std::string_view(v.GetString(), v.GetStringLength()));
+    } else if (v.IsBool()) {
+      store(value, v.GetBool());
+    } else if (v.IsInt64()) {
+      store(value, v.GetInt64());
+    } else if (v.IsNumber()) {
+      store(value, v.GetDouble());
+    } else {
+      StringBuffer strbuf(0, 1024); //allocate 1024byte, default 512bytes
+      Writer<StringBuffer> writer(strbuf);
+      v.Accept(writer);
+      storeJson(value, std::string_view(strbuf.GetString(), strbuf.GetSize()));
     }
+
+    if (isExport)
+      m_env.Add(param, value.text);
+    loaded.push_back(param);
   }
 
-  fclose(fp);
+  if (!snapshot_path.empty()) {
+    std::vector<std::pair<std::string_view, const Settings::Value*>> values;
+    for (std::string_view key : loaded)
+      values.push_back({key, &table.find(key)});
+    if (!SnapshotFile::Write(snapshot_path, source, content_hash, values))
+      LOG_WARNING("Failed to write settings snapshot %s", snapshot_path.c_str());
+  }
 
   return true;
 }
 
-std::string& Settings::get(std::string key)
+const Settings::Value& Settings::Table::find(std::string_view key) const
 {
-  static std::string emptyString = "";
+  static const Value kNullValue;
 
-  if (m_settings.find(key) == m_settings.end()) {
-    return emptyString;
+  const uint64_t hash = HashKey(key);
+  const size_t mask = index.size() - 1;
+  for (size_t slot = hash & mask; index[slot] != kEmptySlot;
+       slot = (slot + 1) & mask) {
+    const Entry& entry = entries[index[slot]];
+    if (entry.hash == hash && entry.name == key)
+      return entry.value;
+  }
+  return kNullValue;
+}
+
+Settings::Value& Settings::Table::intern(std::string_view key)
+{
+  const uint64_t hash = HashKey(key);
+  size_t mask = index.size() - 1;
+  size_t slot = hash & mask;
+  for (; index[slot] != kEmptySlot; slot = (slot + 1) & mask) {
+    Entry& entry = entries[index[slot]];
+    if (entry.hash == hash && entry.name == key)
+      return entry.value;
   }
 
-  return m_settings[key];
+  // Keep the load factor at or below 1/2.
+  if ((entries.size() + 1) * 2 > index.size()) {
+    rehash(index.size() * 2);
+    mask = index.size() - 1;
+    slot = hash & mask;
+    while (index[slot] != kEmptySlot)
+      slot = (slot + 1) & mask;
+  }
+
+  index[slot] = static_cast<uint32_t>(entries.size());
+  entries.push_back({std::string(key), hash, Value()});
+  return entries.back().value;
 }
 
-bool Settings::getBool(std::string key)
+void Settings::Table::rehash(size_t slots)
 {
-  if (m_settings.find(key) == m_settings.end()) {
-    return false;
+  index.assign(slots, kEmptySlot);
+  const size_t mask = slots - 1;
+  for (size_t i = 0; i < entries.size(); i++) {
+    size_t slot = entries[i].hash & mask;
+    while (index[slot] != kEmptySlot)
+      slot = (slot + 1) & mask;
+    index[slot] = static_cast<uint32_t>(i);
   }
+}
+
+// Strings also get their typed forms, since most configs quote everything,
+// e.g. "FLUTTER_ALLOW_TAS": "true".
+void Settings::store(Value& value, std::string_view text)
+{
+  value.type = Type::kString;
+  value.text.assign(text.data(), text.size());
+  value.bool_value = (text == "true");
+
+  const char* str = value.text.c_str();
+  char* end = nullptr;
+  errno = 0;
+  long long i = strtoll(str, &end, 10);
+  value.int_value = (*str && *end == '\0' && errno == 0) ? i : 0;
+  double d = strtod(str, &end);
+  value.double_value = (*str && *end == '\0') ? d : 0.0;
+}
+
+void Settings::store(Value& value, bool b)
+{
+  value.type = Type::kBool;
+  value.text = b ? "true" : "false";
+  value.bool_value = b;
+  value.int_value = b;
+  value.double_value = b;
+}
+
+void Settings::store(Value& value, int64_t i)
+{
+  value.type = Type::kInt;
+  value.text = std::to_string(i);
+  value.bool_value = false;
+  value.int_value = i;
+  value.double_value = static_cast<double>(i);
+}
 
-  if (m_settings[key] ==  "true") return true;
-  return false;
+void Settings::store(Value& value, double d)
+{
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.17g", d);
+  value.type = Type::kDouble;
+  value.text = buf;
+  value.bool_value = false;
+  value.int_value = static_cast<int64_t>(d);
+  value.double_value = d;
+}
+
+void Settings::storeJson(Value& value, std::string_view json)
+{
+  value.type = Type::kJson;
+  value.text.assign(json.data(), json.size());
+  value.bool_value = false;
+  value.int_value = 0;
+  value.double_value = 0.0;
 }
@@ -5,19 +5,54 @@
 #ifndef FLUTTER_RUNNER_SETTINGS_H_
 #define FLUTTER_RUNNER_SETTINGS_H_
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <map>
+#include <string_view>
+#include <thread>
+#include <vector>
 
+#include "environment_builder.h"
 #include "settings_conf.h"   //generated from cmake
 
+// Keys are interned into a flat table when they are loaded or set, and each
+// value keeps its bool/int64/double forms next to the text, so the typed
+// get<T>() calls neither allocate nor parse. Well-known keys live at the
+// fixed slots of settings_key::Id.
+//
+// Writers build a new table and publish it with one atomic pointer store,
+// so readers on any thread never lock and never see a half-updated table.
+// Only the last kRetainedTables tables are kept: references and views
+// returned by get() are meant to be used right away, and must not be held
+// across further set() calls or a reload. Copy values that are kept.
+//
+// Every load() and set() is also recorded, so that when watching is
+// enabled a change to one of the loaded conf files rebuilds the whole
+// table by replaying them in the original order.
 class Settings {
  private:
-  Settings() {};
-  virtual ~Settings() {}
-
-  std::map<std::string, std::string> m_settings;
+  Settings();
+  virtual ~Settings();
 
  public:
+  enum class Type : uint8_t { kNull, kBool, kInt, kDouble, kString, kJson };
+
+  struct Value {
+    Type type = Type::kNull;
+    bool bool_value = false;
+    int64_t int_value = 0;
+    double double_value = 0.0;
+    // String form, as exported to the environment. Raw JSON for kJson.
+    std::string text;
+  };
+
+  // Called on the watcher thread with the keys that were added, changed or
+  // removed by a reload.
+  using Listener = std::function<void(const std::vector<std::string>& keys)>;
+
   static Settings& getInstance()
   {
     static Settings instance;
@@ -32,15 +67,113 @@ class Settings {
 
   bool load(std::string const & conf_path, bool isExport);
 
-  void set(std::string key, std::string value) { m_settings[key] = value; }
-  std::string& get(std::string key);
-  bool getBool(std::string key);
+  void set(settings_key::Id key, std::string_view value);
+  void set(std::string_view key, std::string_view value);
+
+  // Missing keys yield false, 0, 0.0 or an empty string.
+  template <typename T>
+  T get(settings_key::Id key) const { return as<T>(table().entries[key].value); }
+  template <typename T>
+  T get(std::string_view key) const { return as<T>(table().find(key)); }
+
+  const std::string& get(settings_key::Id key) const { return table().entries[key].value.text; }
+  const std::string& get(std::string_view key) const { return table().find(key).text; }
+  bool getBool(std::string_view key) const { return get<bool>(key); }
+  Type type(std::string_view key) const { return table().find(key).type; }
+
+  // Incremented by every published change, for callers caching derived
+  // data or polling for reloads.
+  uint64_t generation() const { return table().generation; }
+
+  inline const std::string& getBundlePath() const { return get(settings_key::kBundlePath); }
+  inline const std::string& getRuntimeMode() const { return get(settings_key::kRuntimeMode); }
+  inline const std::string& getFrameworkVersion() const { return get(settings_key::kFrameworkVersion); }
+  inline const std::string& getDisplayBackend() const { return get(settings_key::kDisplayBackend); }
+
+  // Watches the conf files loaded so far and reloads on changes. Reloads
+  // do not touch the process environment.
+  bool startWatching();
+  void stopWatching();
+
+  int subscribe(Listener listener);
+  void unsubscribe(int id);
+
+  // Rebuilds the table from the recorded loads and sets.
+  void reload();
+
+ private:
+  struct Entry {
+    std::string name;
+    uint64_t hash;
+    Value value;
+  };
+
+  // Immutable once published.
+  struct Table {
+    std::vector<Entry> entries;
+    // Open-addressed with linear probing, holds indices into entries.
+    std::vector<uint32_t> index;
+    uint64_t generation = 0;
+
+    const Value& find(std::string_view key) const;
+    Value& intern(std::string_view key);
+    void rehash(size_t slots);
+  };
+
+  struct JournalEntry {
+    bool is_load;
+    std::string key;    // conf path for loads
+    std::string value;
+  };
+
+  static constexpr uint32_t kEmptySlot = UINT32_MAX;
+  // Published tables kept alive, the current one included. Leaves readers
+  // that loaded the table pointer just before a publish plenty of slack.
+  static constexpr size_t kRetainedTables = 16;
+
+  template <typename T>
+  static T as(const Value& value);
+
+  static std::unique_ptr<Table> newTable();
+  static void store(Value& value, std::string_view text);
+  static void store(Value& value, bool b);
+  static void store(Value& value, int64_t i);
+  static void store(Value& value, double d);
+  static void storeJson(Value& value, std::string_view json);
+  static std::vector<std::string> diff(const Table& from, const Table& to);
+
+  const Table& table() const { return *m_table.load(std::memory_order_acquire); }
 
-  inline std::string& getBundlePath() { return get(FLUTTER_BUNDLE_PATH); }
-  inline std::string& getRuntimeMode() { return get(FLUTTER_RUNTIME_MODE); }
-  inline std::string& getFrameworkVersion() { return get(FLUTTER_FRAMEWORK_VERSION); }
-  inline std::string& getDisplayBackend() { return get(FLUTTER_DISPLAY_BACKEND); }
+  // Must hold m_writeMutex.
+  std::unique_ptr<Table> beginWrite() const;
+  void publish(std::unique_ptr<Table> table);
+  bool loadConf(Table& table, std::string const & conf_path, bool isExport);
+
+  void watch(int inotify_fd, int stop_fd, std::vector<std::string> paths);
+  void notify(const std::vector<std::string>& keys);
+
+  std::atomic<const Table*> m_table;
+  std::vector<std::unique_ptr<Table>> m_tables;
+  std::vector<JournalEntry> m_journal;
+  std::mutex m_writeMutex;
+  // Exported keys, installed once per init()/setEnv()/load() call.
+  EnvironmentBuilder m_env;
+
+  std::thread m_watcher;
+  int m_stopFd = -1;
+
+  std::mutex m_listenerMutex;
+  std::vector<std::pair<int, Listener>> m_listeners;
+  int m_nextListenerId = 1;
 };
 
-#endif // FLUTTER_RUNNER_SETTINGS_H_
+template <>
+inline bool Settings::as<bool>(const Value& value) { return value.bool_value; }
+template <>
+inline int64_t Settings::as<int64_t>(const Value& value) { return value.int_value; }
+template <>
+inline double Settings::as<double>(const Value& value) { return value.double_value; }
+template <>
+inline std::string_view Settings::as<std::string_view>(const Value& value) { return value.text; }
 
+#endif // FLUTTER_RUNNER_SETTINGS_H_
@@ -12,11 +12,64 @@ static const char* const kSettingsFile  = "/etc/palm/flutter-conf.json";
 #define FLUTTER_APP_ID "FLUTTER_APP_ID"
 #define FLUTTER_BUNDLE_PATH "FLUTTER_BUNDLE_PATH"
 #define FLUTTER_ASSETS_PATH "FLUTTER_ASSETS_PATH"
+#define FLUTTER_APP_LOG_PATH "FLUTTER_APP_LOG_PATH"
+#define FLUTTER_TEMP_HOME "FLUTTER_TEMP_HOME"
 
 #define FLUTTER_ALLOW_TAS "FLUTTER_ALLOW_TAS"
 
+// "vsync" aligns idle wakeups to the estimated display refresh timeline.
+#define FLUTTER_FRAME_PACING "FLUTTER_FRAME_PACING"
+static const char* const kFramePacingVsync = "vsync";
+// "false" disables the main loop telemetry (dumped on SIGUSR1 and at exit).
+#define FLUTTER_LOOP_TELEMETRY "FLUTTER_LOOP_TELEMETRY"
+// Output path of the startup timeline, or "true" for FLUTTER_APP_LOG_PATH.
+#define FLUTTER_STARTUP_TRACE "FLUTTER_STARTUP_TRACE"
+// "true" reloads the settings when one of the loaded conf files changes.
+#define FLUTTER_SETTINGS_HOT_RELOAD "FLUTTER_SETTINGS_HOT_RELOAD"
+// Environment variable naming a file that receives the runner log instead
+// of PmLog.
+#define FLUTTER_LOG_FILE "FLUTTER_LOG_FILE"
+
 #define FLUTTER_RUNTIME_MODE "runtime_mode"
 #define FLUTTER_FRAMEWORK_VERSION "flutter_framework_version"
 #define FLUTTER_DISPLAY_BACKEND "display_backend"
 
+#define FLUTTER_DEFAULT_RUNTIME_MODE "release"
+#define FLUTTER_DEFAULT_FRAMEWORK_VERSION "latest"
+
+// Well-known keys get fixed slots in the Settings table, so lookups by id
+// need neither hashing nor string compares.
+namespace settings_key {
+enum Id : unsigned {
+  kAppId,
+  kBundlePath,
+  kAssetsPath,
+  kAppLogPath,
+  kAllowTas,
+  kFramePacing,
+  kLoopTelemetry,
+  kStartupTrace,
+  kSettingsHotReload,
+  kRuntimeMode,
+  kFrameworkVersion,
+  kDisplayBackend,
+  kWellKnownCount
+};
+
+static constexpr const char* kNames[kWellKnownCount] = {
+  FLUTTER_APP_ID,
+  FLUTTER_BUNDLE_PATH,
+  FLUTTER_ASSETS_PATH,
+  FLUTTER_APP_LOG_PATH,
+  FLUTTER_ALLOW_TAS,
+  FLUTTER_FRAME_PACING,
+  FLUTTER_LOOP_TELEMETRY,
+  FLUTTER_STARTUP_TRACE,
+  FLUTTER_SETTINGS_HOT_RELOAD,
+  FLUTTER_RUNTIME_MODE,
+  FLUTTER_FRAMEWORK_VERSION,
+  FLUTTER_DISPLAY_BACKEND,
+};
+}  // namespace settings_key
+
 #endif  // FLUTTER_RUNNER_SETTINGS_CONFIG_H_
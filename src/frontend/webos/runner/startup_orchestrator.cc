@@ -0,0 +1,74 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "startup_orchestrator.h"
+
+#include "logger.h"
+#include "page_prefetcher.h"
+#include "settings_conf.h"
+#include "startup_tracer.h"
+
+void StartupOrchestrator::PreloadLibraries(const std::string& app_id,
+                                           const std::string& bundle_path,
+                                           const std::string& display_backend) {
+  Join();
+
+  // Settings::setEnv() always selects the default runtime mode and
+  // framework version, so only the bundle path can be guessed wrong.
+  embedder_path_ = EmbedderLoader::ResolveRuntimePath(
+      app_id, bundle_path, display_backend, FLUTTER_DEFAULT_RUNTIME_MODE,
+      FLUTTER_DEFAULT_FRAMEWORK_VERSION);
+  plugin_interface_path_ = WebosInterfaceLoader::GetInterfacePath(bundle_path);
+
+  PagePrefetcher::getInstance().Start(
+      app_id, PagePrefetcher::StartupFiles(bundle_path, embedder_path_));
+
+  worker_ = std::thread([this]() {
+    TRACE_STARTUP_SCOPE("PreloadLibraries");
+    embedder_ = std::make_unique<EmbedderLoader>(embedder_path_, true);
+    plugin_interface_ =
+        std::make_unique<WebosInterfaceLoader>(plugin_interface_path_, true);
+  });
+}
+
+void StartupOrchestrator::Join() {
+  if (worker_.joinable()) {
+    TRACE_STARTUP_SCOPE("PreloadLibraries::Join");
+    worker_.join();
+  }
+}
+
+std::unique_ptr<EmbedderLoader> StartupOrchestrator::TakeEmbedder(
+    const std::string& path) {
+  Join();
+  if (!embedder_ || path != embedder_path_ || !embedder_->IsLoaded()) {
+    if (embedder_)
+      LOG_INFO("Speculative embedder %s discarded", embedder_path_.c_str());
+    embedder_ = nullptr;
+    return nullptr;
+  }
+  if (!embedder_->Promote()) {
+    embedder_ = nullptr;
+    return nullptr;
+  }
+  return std::move(embedder_);
+}
+
+std::unique_ptr<WebosInterfaceLoader> StartupOrchestrator::TakePluginInterface(
+    const std::string& path) {
+  Join();
+  if (!plugin_interface_ || path != plugin_interface_path_ ||
+      !plugin_interface_->IsLoaded()) {
+    if (plugin_interface_)
+      LOG_INFO("Speculative plugin interface %s discarded",
+               plugin_interface_path_.c_str());
+    plugin_interface_ = nullptr;
+    return nullptr;
+  }
+  if (!plugin_interface_->Promote()) {
+    plugin_interface_ = nullptr;
+    return nullptr;
+  }
+  return std::move(plugin_interface_);
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_RUNNER_STARTUP_ORCHESTRATOR_H_
+#define FLUTTER_RUNNER_STARTUP_ORCHESTRATOR_H_
+
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "flutter_embedder_loader.h"
+
+// Overlaps the embedder and plugin interface dlopen() with the config and
+// app descriptor parsing on the main thread.
+//
+// As soon as the display backend is known, PreloadLibraries() guesses the
+// library paths from the command line bundle path and opens them on a
+// helper thread. FlutterWindow::OnCreate() joins it through the Take*()
+// calls, which only hand out a loader opened from the path the settings
+// finally resolve to. On a wrong guess they return nullptr and the caller
+// loads serially as before. The guessed libraries are opened without
+// RTLD_NODELETE, and the embedder RTLD_LOCAL, until the Take*() calls
+// promote them, so a discarded one is really unloaded.
+class StartupOrchestrator {
+ private:
+  StartupOrchestrator() {}
+  virtual ~StartupOrchestrator() { Join(); }
+
+ public:
+  static StartupOrchestrator& getInstance()
+  {
+    static StartupOrchestrator instance;
+    return instance;
+  }
+
+  // Must not be called while a previous preload is still pending.
+  void PreloadLibraries(const std::string& app_id,
+                        const std::string& bundle_path,
+                        const std::string& display_backend);
+
+  std::unique_ptr<EmbedderLoader> TakeEmbedder(const std::string& path);
+  std::unique_ptr<WebosInterfaceLoader> TakePluginInterface(
+      const std::string& path);
+
+ private:
+  void Join();
+
+  std::thread worker_;
+  std::string embedder_path_;
+  std::string plugin_interface_path_;
+  std::unique_ptr<EmbedderLoader> embedder_;
+  std::unique_ptr<WebosInterfaceLoader> plugin_interface_;
+};
+
+#endif  // FLUTTER_RUNNER_STARTUP_ORCHESTRATOR_H_
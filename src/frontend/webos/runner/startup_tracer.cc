@@ -0,0 +1,212 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "startup_tracer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+#include "logger.h"
+#include "settings.h"
+
+using namespace rapidjson;
+
+namespace {
+
+bool IsTraceEnabled(const char* value) {
+  return value && value[0] != '\0' && strcmp(value, "false") != 0;
+}
+
+int64_t ReadRssKb() {
+  static const long kPageKb = sysconf(_SC_PAGESIZE) / 1024;
+
+  FILE* fp = fopen("/proc/self/statm", "r");
+  if (fp == NULL)
+    return 0;
+  long size = 0;
+  long resident = 0;
+  if (fscanf(fp, "%ld %ld", &size, &resident) != 2)
+    resident = 0;
+  fclose(fp);
+  return static_cast<int64_t>(resident) * kPageKb;
+}
+
+void WriteArgs(Writer<StringBuffer>& writer,
+               const StartupTracer::Snapshot& begin,
+               const StartupTracer::Snapshot& end) {
+  writer.Key("args");
+  writer.StartObject();
+  writer.Key("rss_kb");
+  writer.Int64(end.rss_kb);
+  writer.Key("rss_kb_delta");
+  writer.Int64(end.rss_kb - begin.rss_kb);
+  writer.Key("minor_faults");
+  writer.Int64(end.minor_faults - begin.minor_faults);
+  writer.Key("major_faults");
+  writer.Int64(end.major_faults - begin.major_faults);
+  writer.EndObject();
+}
+
+}  // namespace
+
+std::atomic<bool> StartupTracer::enabled_{
+    IsTraceEnabled(getenv(FLUTTER_STARTUP_TRACE))};
+
+StartupTracer::Scope::Scope(const char* name) : name_(name) {
+  if (StartupTracer::IsEnabled())
+    begin_ = StartupTracer::Now();
+}
+
+StartupTracer::Scope::~Scope() {
+  // Skips scopes entered before tracing was enabled.
+  if (begin_.ts_us)
+    StartupTracer::getInstance().AddPhase(name_, begin_, StartupTracer::Now());
+}
+
+void StartupTracer::EnableFromSettings() {
+  // The environment takes precedence, as in Flush().
+  if (IsEnabled() || getenv(FLUTTER_STARTUP_TRACE))
+    return;
+  const std::string value =
+      Settings::getInstance().get(settings_key::kStartupTrace);
+  if (IsTraceEnabled(value.c_str()))
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+StartupTracer::Snapshot StartupTracer::Now() {
+  Snapshot snapshot = {};
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  snapshot.ts_us = static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+  if (!IsEnabled())
+    return snapshot;
+
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    snapshot.minor_faults = usage.ru_minflt;
+    snapshot.major_faults = usage.ru_majflt;
+  } else {
+    snapshot.minor_faults = 0;
+    snapshot.major_faults = 0;
+  }
+  snapshot.rss_kb = ReadRssKb();
+  return snapshot;
+}
+
+void StartupTracer::AddPhase(const char* name,
+                             const Snapshot& begin,
+                             const Snapshot& end) {
+  if (!IsEnabled())
+    return;
+  int tid = static_cast<int>(syscall(SYS_gettid));
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!flushed_)
+    events_.push_back({name, begin, end, tid});
+}
+
+void StartupTracer::AddCounter(const char* name, int64_t value) {
+  if (!IsEnabled())
+    return;
+  int64_t ts_us = Now().ts_us;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!flushed_)
+    counters_.push_back({name, ts_us, value});
+}
+
+void StartupTracer::Flush() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (flushed_)
+      return;
+    flushed_ = true;
+  }
+  if (!IsEnabled())
+    return;
+
+  Settings& settings = Settings::getInstance();
+  const char* env = getenv(FLUTTER_STARTUP_TRACE);
+  std::string path = env ? env : settings.get(settings_key::kStartupTrace);
+  if (path.empty() || path == "false")
+    return;
+
+  if (path == "true") {
+    std::string log_path = settings.get(settings_key::kAppLogPath);
+    std::string app_id = settings.get(settings_key::kAppId);
+    path = (log_path.empty() ? std::string("/tmp") : log_path) + "/" +
+           (app_id.empty() ? std::string("flutter") : app_id) +
+           ".startup-trace.json";
+  }
+
+  if (Write(path))
+    LOG_INFO("Startup trace written to %s", path.c_str());
+  else
+    LOG_WARNING("Failed to write startup trace: %s", path.c_str());
+}
+
+bool StartupTracer::Write(const std::string& path) {
+  const int pid = static_cast<int>(getpid());
+
+  StringBuffer buffer;
+  Writer<StringBuffer> writer(buffer);
+  writer.StartObject();
+  writer.Key("displayTimeUnit");
+  writer.String("ms");
+  writer.Key("traceEvents");
+  writer.StartArray();
+  for (const Event& event : events_) {
+    writer.StartObject();
+    writer.Key("name");
+    writer.String(event.name);
+    writer.Key("cat");
+    writer.String("startup");
+    writer.Key("ph");
+    writer.String("X");
+    writer.Key("ts");
+    writer.Int64(event.begin.ts_us);
+    writer.Key("dur");
+    writer.Int64(event.end.ts_us - event.begin.ts_us);
+    writer.Key("pid");
+    writer.Int(pid);
+    writer.Key("tid");
+    writer.Int(event.tid);
+    WriteArgs(writer, event.begin, event.end);
+    writer.EndObject();
+  }
+  for (const Counter& counter : counters_) {
+    writer.StartObject();
+    writer.Key("name");
+    writer.String(counter.name);
+    writer.Key("cat");
+    writer.String("startup");
+    writer.Key("ph");
+    writer.String("C");
+    writer.Key("ts");
+    writer.Int64(counter.ts_us);
+    writer.Key("pid");
+    writer.Int(pid);
+    writer.Key("args");
+    writer.StartObject();
+    writer.Key("value");
+    writer.Int64(counter.value);
+    writer.EndObject();
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.EndObject();
+
+  FILE* fp = fopen(path.c_str(), "w");
+  if (fp == NULL)
+    return false;
+  bool ok = fwrite(buffer.GetString(), 1, buffer.GetSize(), fp) ==
+            buffer.GetSize();
+  return (fclose(fp) == 0) && ok;
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_RUNNER_STARTUP_TRACER_H_
+#define FLUTTER_RUNNER_STARTUP_TRACER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Records the startup phases of the runner as a Chrome trace-event timeline
+// (chrome://tracing, Perfetto) with monotonic timestamps and per-phase RSS
+// and page-fault deltas.
+//
+// Tracing is enabled by FLUTTER_STARTUP_TRACE, set either to an explicit
+// path or to "true" for FLUTTER_APP_LOG_PATH/<appId>.startup-trace.json.
+// The environment is checked once at startup; the flutter-conf.json key
+// only takes effect from EnableFromSettings() on, so the phases before the
+// config is loaded are missing then. While disabled, scopes, phases and
+// counters cost a clock read at most.
+class StartupTracer {
+ private:
+  StartupTracer() {}
+  virtual ~StartupTracer() {}
+
+ public:
+  struct Snapshot {
+    int64_t ts_us;
+    int64_t rss_kb;
+    int64_t minor_faults;
+    int64_t major_faults;
+  };
+
+  // Records the enclosing block as one phase.
+  class Scope {
+   public:
+    explicit Scope(const char* name);
+    ~Scope();
+
+    // Prevent copying.
+    Scope(Scope const&) = delete;
+    Scope& operator=(Scope const&) = delete;
+
+   private:
+    const char* name_;
+    Snapshot begin_ = {};
+  };
+
+  static StartupTracer& getInstance()
+  {
+    static StartupTracer instance;
+    return instance;
+  }
+
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  // Enables tracing when the loaded Settings ask for it.
+  static void EnableFromSettings();
+
+  // Only |ts_us| is filled in while tracing is disabled.
+  static Snapshot Now();
+
+  // |name| must outlive the tracer, i.e. be a string literal.
+  void AddPhase(const char* name, const Snapshot& begin, const Snapshot& end);
+  void AddCounter(const char* name, int64_t value);
+
+  // Writes the timeline once, if enabled. Later calls are no-ops.
+  void Flush();
+
+ private:
+  struct Event {
+    const char* name;
+    Snapshot begin;
+    Snapshot end;
+    int tid;
+  };
+  struct Counter {
+    const char* name;
+    int64_t ts_us;
+    int64_t value;
+  };
+
+  bool Write(const std::string& path);
+
+  static std::atomic<bool> enabled_;
+
+  std::mutex mutex_;
+  std::vector<Event> events_;
+  std::vector<Counter> counters_;
+  bool flushed_ = false;
+};
+
+#define TRACE_STARTUP_CONCAT_(a, b) a##b
+#define TRACE_STARTUP_CONCAT(a, b) TRACE_STARTUP_CONCAT_(a, b)
+#define TRACE_STARTUP_SCOPE(name) \
+  StartupTracer::Scope TRACE_STARTUP_CONCAT(startup_trace_scope_, __LINE__)(name)
+
+#endif  // FLUTTER_RUNNER_STARTUP_TRACER_H_
@@ -17,6 +17,12 @@
 
 #include "rapidjson.h"
 
+#if RAPIDJSON_HAS_CXX11_THREADS
+#include <atomic>
+#include <mutex>
+#include <new>
+#endif
+
 RAPIDJSON_NAMESPACE_BEGIN
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -279,6 +285,352 @@ private:
     BaseAllocator* ownBaseAllocator_;   //!< base allocator created by this object.
 };
 
+#if RAPIDJSON_HAS_CXX11_THREADS
+
+/*! \def RAPIDJSON_POOL_THREAD_CACHE
+    \ingroup RAPIDJSON_CONFIG
+    \brief Freed blocks of each size a thread keeps for ThreadCachingPoolAllocator.
+*/
+#ifndef RAPIDJSON_POOL_THREAD_CACHE
+#define RAPIDJSON_POOL_THREAD_CACHE 8
+#endif
+
+/*! \def RAPIDJSON_POOL_GLOBAL_RESERVE
+    \ingroup RAPIDJSON_CONFIG
+    \brief Freed blocks of each size shared by all threads for ThreadCachingPoolAllocator.
+*/
+#ifndef RAPIDJSON_POOL_GLOBAL_RESERVE
+#define RAPIDJSON_POOL_GLOBAL_RESERVE 32
+#endif
+
+namespace internal {
+
+///////////////////////////////////////////////////////////////////////////////
+// BlockRecycler
+
+//! Process-wide recycler of memory blocks of one size.
+/*! A freed block goes to a list of the freeing thread, which hands it out
+    again without locking. Beyond \ref RAPIDJSON_POOL_THREAD_CACHE blocks it
+    goes to a reserve shared by all threads under a mutex, and beyond
+    \ref RAPIDJSON_POOL_GLOBAL_RESERVE back to the system. A thread that runs
+    dry takes from the reserve before asking the system, and gives its list
+    to the reserve when it exits.
+
+    \tparam BlockSize Size of every block in bytes.
+*/
+template <size_t BlockSize>
+class BlockRecycler {
+public:
+    //! Where blocks came from and went to since the process started.
+    /*! Reuse from other threads' own lists is counted when they next go
+        to the reserve or exit.
+    */
+    struct Stats {
+        uint64_t threadHits;        //!< Blocks reused from a thread's own list.
+        uint64_t reserveHits;       //!< Blocks reused from the shared reserve.
+        uint64_t systemAllocations; //!< Blocks allocated from the system.
+        uint64_t systemFrees;       //!< Blocks returned to the system.
+    };
+
+    //! Takes a block, or returns NULL if the system is out of memory.
+    static void* Acquire() {
+        Reserve& reserve = Global();
+        if (ThreadCache* cache = Local()) {
+            if (Node* node = cache->head) {
+                cache->head = node->next;
+                cache->count--;
+                cache->hits++;
+                return node;
+            }
+            cache->Flush();
+        }
+        {
+            std::lock_guard<std::mutex> lock(reserve.mutex);
+            if (Node* node = reserve.head) {
+                reserve.head = node->next;
+                reserve.count--;
+                reserve.reserveHits.fetch_add(1, std::memory_order_relaxed);
+                return node;
+            }
+        }
+        reserve.systemAllocations.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(BlockSize, std::nothrow);
+    }
+
+    //! Gives back a block from Acquire(), on any thread.
+    static void Release(void* block) {
+        Node* node = static_cast<Node*>(block);
+        ThreadCache* cache = Local();
+        if (cache && cache->count < RAPIDJSON_POOL_THREAD_CACHE) {
+            node->next = cache->head;
+            cache->head = node;
+            cache->count++;
+        }
+        else
+            Retire(node);
+    }
+
+    static Stats GetStats() {
+        const Reserve& reserve = Global();
+        const ThreadCache* cache = Local();
+        Stats stats = {
+            reserve.threadHits.load(std::memory_order_relaxed) + (cache ? cache->hits : 0),
+            reserve.reserveHits.load(std::memory_order_relaxed),
+            reserve.systemAllocations.load(std::memory_order_relaxed),
+            reserve.systemFrees.load(std::memory_order_relaxed)
+        };
+        return stats;
+    }
+
+private:
+    struct Node {
+        Node* next;
+    };
+
+    struct ThreadCache {
+        ThreadCache() : head(0), count(0), hits(0) {}
+        ~ThreadCache() {
+            Exited() = true;
+            Flush();
+            while (Node* node = head) {
+                head = node->next;
+                Retire(node);
+            }
+        }
+        // Counted here, as an atomic per reuse would cost more than the reuse.
+        void Flush() {
+            Global().threadHits.fetch_add(hits, std::memory_order_relaxed);
+            hits = 0;
+        }
+        Node* head;
+        size_t count;
+        uint64_t hits;
+    };
+
+    struct Reserve {
+        Reserve() : head(0), count(0), threadHits(0), reserveHits(0), systemAllocations(0), systemFrees(0) {}
+        std::mutex mutex;
+        Node* head;
+        size_t count;
+        std::atomic<uint64_t> threadHits;
+        std::atomic<uint64_t> reserveHits;
+        std::atomic<uint64_t> systemAllocations;
+        std::atomic<uint64_t> systemFrees;
+    };
+
+    // Set once the thread's cache is destroyed, for blocks freed by
+    // thread_local objects destroyed after it.
+    static bool& Exited() {
+        static thread_local bool exited = false;
+        return exited;
+    }
+
+    static ThreadCache* Local() {
+        if (Exited())
+            return 0;
+        static thread_local ThreadCache cache;
+        return &cache;
+    }
+
+    // Never destroyed, so threads may outlive static destruction.
+    static Reserve& Global() {
+        static Reserve* reserve = new Reserve();
+        return *reserve;
+    }
+
+    static void Retire(Node* node) {
+        Reserve& reserve = Global();
+        {
+            std::lock_guard<std::mutex> lock(reserve.mutex);
+            if (reserve.count < RAPIDJSON_POOL_GLOBAL_RESERVE) {
+                node->next = reserve.head;
+                reserve.head = node;
+                reserve.count++;
+                return;
+            }
+        }
+        reserve.systemFrees.fetch_add(1, std::memory_order_relaxed);
+        ::operator delete(node);
+    }
+};
+
+} // namespace internal
+
+///////////////////////////////////////////////////////////////////////////////
+// ThreadCachingPoolAllocator
+
+//! Memory pool allocator whose chunks are recycled across documents and threads.
+/*! Allocates like MemoryPoolAllocator, but takes its chunks from
+    internal::BlockRecycler and gives them back when cleared or destroyed,
+    so documents that come and go reuse the same chunks. The allocator
+    objects that GenericDocument and internal::Stack create with
+    RAPIDJSON_NEW are recycled the same way. Once warm, creating, parsing
+    and destroying a document of up to a chunk per allocator does not
+    touch the system allocator:
+\code
+typedef GenericDocument<UTF8<>, ThreadCachingPoolAllocator, ThreadCachingPoolAllocator> CachedDocument;
+\endcode
+    One allocator must be used by one thread at a time, but may be
+    destroyed on another thread than the one that filled it.
+
+    Chunks hold \ref RAPIDJSON_ALLOCATOR_DEFAULT_CHUNK_CAPACITY bytes
+    including their header. Larger blocks get a chunk of their own, which
+    goes back to the system.
+
+    \note implements Allocator concept
+*/
+class ThreadCachingPoolAllocator {
+public:
+    static const bool kNeedFree = false;    //!< Tell users that no need to call Free() with this allocator. (concept Allocator)
+
+    //! Chunk sources, see internal::BlockRecycler::Stats.
+    typedef internal::BlockRecycler<RAPIDJSON_ALLOCATOR_DEFAULT_CHUNK_CAPACITY>::Stats Stats;
+
+    ThreadCachingPoolAllocator() : chunkHead_(0) {}
+
+    //! Destructor, which recycles all chunks.
+    ~ThreadCachingPoolAllocator() { Clear(); }
+
+    //! Recycles all memory chunks.
+    void Clear() {
+        while (ChunkHeader* chunk = chunkHead_) {
+            chunkHead_ = chunk->next;
+            if (chunk->capacity == kChunkCapacity)
+                ChunkRecycler::Release(chunk);
+            else
+                ::operator delete(chunk);
+        }
+    }
+
+    //! Computes the total capacity of allocated memory chunks.
+    size_t Capacity() const {
+        size_t capacity = 0;
+        for (ChunkHeader* c = chunkHead_; c != 0; c = c->next)
+            capacity += c->capacity;
+        return capacity;
+    }
+
+    //! Computes the memory blocks allocated.
+    size_t Size() const {
+        size_t size = 0;
+        for (ChunkHeader* c = chunkHead_; c != 0; c = c->next)
+            size += c->size;
+        return size;
+    }
+
+    //! Allocates a memory block. (concept Allocator)
+    void* Malloc(size_t size) {
+        if (!size)
+            return NULL;
+
+        size = RAPIDJSON_ALIGN(size);
+        if (chunkHead_ == 0 || chunkHead_->size + size > chunkHead_->capacity)
+            if (!AddChunk(size))
+                return NULL;
+
+        void *buffer = reinterpret_cast<char *>(chunkHead_) + kHeaderSize + chunkHead_->size;
+        chunkHead_->size += size;
+        return buffer;
+    }
+
+    //! Resizes a memory block (concept Allocator)
+    void* Realloc(void* originalPtr, size_t originalSize, size_t newSize) {
+        if (originalPtr == 0)
+            return Malloc(newSize);
+
+        if (newSize == 0)
+            return NULL;
+
+        originalSize = RAPIDJSON_ALIGN(originalSize);
+        newSize = RAPIDJSON_ALIGN(newSize);
+
+        // Do not shrink if new size is smaller than original
+        if (originalSize >= newSize)
+            return originalPtr;
+
+        // Simply expand it if it is the last allocation and there is sufficient space
+        if (originalPtr == reinterpret_cast<char *>(chunkHead_) + kHeaderSize + chunkHead_->size - originalSize) {
+            size_t increment = static_cast<size_t>(newSize - originalSize);
+            if (chunkHead_->size + increment <= chunkHead_->capacity) {
+                chunkHead_->size += increment;
+                return originalPtr;
+            }
+        }
+
+        // Realloc process: allocate and copy memory, do not free original buffer.
+        if (void* newBuffer = Malloc(newSize)) {
+            if (originalSize)
+                std::memcpy(newBuffer, originalPtr, originalSize);
+            return newBuffer;
+        }
+        else
+            return NULL;
+    }
+
+    //! Frees a memory block (concept Allocator)
+    static void Free(void *ptr) { (void)ptr; } // Do nothing
+
+    //! Where chunks of all allocators of this type came from so far.
+    static Stats GetStats() { return ChunkRecycler::GetStats(); }
+
+    // Recycle allocator objects created by RAPIDJSON_NEW as well.
+    static void* operator new(size_t size) {
+        if (size == sizeof(ThreadCachingPoolAllocator))
+            if (void* p = internal::BlockRecycler<sizeof(ThreadCachingPoolAllocator)>::Acquire())
+                return p;
+        return ::operator new(size);
+    }
+    static void operator delete(void* ptr, size_t size) {
+        if (ptr && size == sizeof(ThreadCachingPoolAllocator))
+            internal::BlockRecycler<sizeof(ThreadCachingPoolAllocator)>::Release(ptr);
+        else
+            ::operator delete(ptr);
+    }
+
+private:
+    //! Copy constructor is not permitted.
+    ThreadCachingPoolAllocator(const ThreadCachingPoolAllocator& rhs) /* = delete */;
+    //! Copy assignment operator is not permitted.
+    ThreadCachingPoolAllocator& operator=(const ThreadCachingPoolAllocator& rhs) /* = delete */;
+
+    //! Chunk header for perpending to each chunk.
+    struct ChunkHeader {
+        size_t capacity;    //!< Capacity of the chunk in bytes (excluding the header itself).
+        size_t size;        //!< Current size of allocated memory in bytes.
+        ChunkHeader *next;  //!< Next chunk in the linked list.
+    };
+
+    typedef internal::BlockRecycler<RAPIDJSON_ALLOCATOR_DEFAULT_CHUNK_CAPACITY> ChunkRecycler;
+
+    static const size_t kHeaderSize = RAPIDJSON_ALIGN(sizeof(ChunkHeader));
+    static const size_t kChunkCapacity = RAPIDJSON_ALLOCATOR_DEFAULT_CHUNK_CAPACITY - kHeaderSize;
+
+    //! Adds a chunk with room for at least \c size bytes.
+    bool AddChunk(size_t size) {
+        ChunkHeader* chunk;
+        size_t capacity;
+        if (size <= kChunkCapacity) {
+            chunk = static_cast<ChunkHeader*>(ChunkRecycler::Acquire());
+            capacity = kChunkCapacity;
+        }
+        else {
+            chunk = static_cast<ChunkHeader*>(::operator new(kHeaderSize + size, std::nothrow));
+            capacity = size;
+        }
+        if (!chunk)
+            return false;
+        chunk->capacity = capacity;
+        chunk->size = 0;
+        chunk->next = chunkHead_;
+        chunkHead_ = chunk;
+        return true;
+    }
+
+    ChunkHeader *chunkHead_;    //!< Head of the chunk linked-list. Only the head chunk serves allocation.
+};
+
+#endif // RAPIDJSON_HAS_CXX11_THREADS
+
 RAPIDJSON_NAMESPACE_END
 
 #endif // RAPIDJSON_ENCODINGS_H_
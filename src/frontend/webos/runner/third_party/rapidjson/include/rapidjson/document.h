@@ -404,6 +404,44 @@ inline GenericStringRef<CharType> StringRef(const std::basic_string<CharType>& s
 }
 #endif
 
+///////////////////////////////////////////////////////////////////////////////
+// GenericStaticKey
+
+//! Member name with its length and hash worked out in advance.
+/*! Looking up a member by \c const \c Ch* takes a StrLen() and, for objects
+    with a member index (\ref RAPIDJSON_MEMBER_INDEX), a hash of the name on
+    every call. A key declared once, ideally as \c constexpr, does that work
+    at compile time:
+    \code
+    static constexpr rapidjson::StaticKey kTitle("title");
+    const rapidjson::Value& title = appinfo[kTitle];
+    \endcode
+    GenericValue::FindMember(), HasMember() and operator[] and
+    GenericPointer::Append() accept it. Names are compared by length first,
+    and by hash in indexed objects, before their code units.
+
+    \tparam CharType character type of the name
+    \note Needs C++14 to be \c constexpr; otherwise it is worked out when
+        the key is constructed.
+*/
+template <typename CharType>
+struct GenericStaticKey {
+    typedef CharType Ch; //!< character type of the name
+
+    //! Key for a string literal.
+    template <SizeType N>
+    explicit RAPIDJSON_CONSTEXPR GenericStaticKey(const CharType (&str)[N])
+        : s(str), length(N - 1), hash(internal::StrHash(str, N - 1)) {}
+
+    //! Key for a name of known length, which must outlive the key.
+    RAPIDJSON_CONSTEXPR GenericStaticKey(const CharType* str, SizeType len)
+        : s(str), length(len), hash(internal::StrHash(str, len)) {}
+
+    const Ch* const s;      //!< name, not necessarily null-terminated
+    const SizeType length;  //!< length of the name
+    const uint32_t hash;    //!< internal::StrHash() of the name
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // GenericValue type traits
 namespace internal {
@@ -653,7 +691,7 @@ public:
         switch (rhs.GetType()) {
         case kObjectType: {
                 SizeType count = rhs.data_.o.size;
-                Member* lm = reinterpret_cast<Member*>(allocator.Malloc(count * sizeof(Member)));
+                Member* lm = reinterpret_cast<Member*>(allocator.Malloc(MembersSize(count)));
                 const typename GenericValue<Encoding,SourceAllocator>::Member* rm = rhs.GetMembersPointer();
                 for (SizeType i = 0; i < count; i++) {
                     new (&lm[i].name) GenericValue(rm[i].name, allocator, copyConstStrings);
@@ -662,6 +700,7 @@ public:
                 data_.f.flags = kObjectFlag;
                 data_.o.size = data_.o.capacity = count;
                 SetMembersPointer(lm);
+                BuildMemberIndexRaw();
             }
             break;
         case kArrayType: {
@@ -1150,6 +1189,20 @@ public:
     template <typename SourceAllocator>
     const GenericValue& operator[](const GenericValue<Encoding, SourceAllocator>& name) const { return const_cast<GenericValue&>(*this)[name]; }
 
+    //! Get a value from an object associated with a precomputed key.
+    /*! \pre IsObject() == true
+        \note Like \ref operator[](const GenericValue&), without building a name value or hashing it.
+    */
+    GenericValue& operator[](const GenericStaticKey<Ch>& key) {
+        MemberIterator member = FindMember(key);
+        if (member != MemberEnd())
+            return member->value;
+        RAPIDJSON_ASSERT(false);    // see operator[](T*)
+        static char buffer[sizeof(GenericValue)];
+        return *new (buffer) GenericValue();
+    }
+    const GenericValue& operator[](const GenericStaticKey<Ch>& key) const { return const_cast<GenericValue&>(*this)[key]; }
+
 #if RAPIDJSON_HAS_STDSTRING
     //! Get a value from an object associated with name (string object).
     GenericValue& operator[](const std::basic_string<Ch>& name) { return (*this)[GenericValue(StringRef(name))]; }
@@ -1178,12 +1231,56 @@ public:
     GenericValue& MemberReserve(SizeType newCapacity, Allocator &allocator) {
         RAPIDJSON_ASSERT(IsObject());
         if (newCapacity > data_.o.capacity) {
-            SetMembersPointer(reinterpret_cast<Member*>(allocator.Realloc(GetMembersPointer(), data_.o.capacity * sizeof(Member), newCapacity * sizeof(Member))));
+            SetMembersPointer(reinterpret_cast<Member*>(allocator.Realloc(GetMembersPointer(), MembersSize(data_.o.capacity), MembersSize(newCapacity))));
             data_.o.capacity = newCapacity;
+            BuildMemberIndexRaw();
         }
         return *this;
     }
 
+    //! Index the members of the object by name, see \ref RAPIDJSON_MEMBER_INDEX.
+    /*! Objects with room for \c RAPIDJSON_MEMBER_INDEX_THRESHOLD members are
+        indexed as they are built and kept indexed as they change; this
+        reserves that capacity for a smaller object that is looked up often.
+        Does nothing unless \c RAPIDJSON_MEMBER_INDEX is 1.
+        \param allocator    Allocator for reallocating memory. It must be the same one as used before. Commonly use GenericDocument::GetAllocator().
+        \return The value itself for fluent API.
+        \note Linear time complexity.
+    */
+    GenericValue& BuildMemberIndex(Allocator& allocator) {
+        RAPIDJSON_ASSERT(IsObject());
+        if (RAPIDJSON_MEMBER_INDEX && data_.o.capacity < RAPIDJSON_MEMBER_INDEX_THRESHOLD)
+            MemberReserve(RAPIDJSON_MEMBER_INDEX_THRESHOLD, allocator);
+        return *this;
+    }
+
+    //! Rebuild the member index after renaming or reordering members in place.
+    /*! The index follows AddMember(), RemoveMember() and EraseMember(), but
+        not names changed or members swapped (e.g. by std::sort()) through
+        member iterators. Call this afterwards; lookups may miss until then.
+        \note Linear time complexity.
+    */
+    GenericValue& RebuildMemberIndex() {
+        RAPIDJSON_ASSERT(IsObject());
+        BuildMemberIndexRaw();
+        return *this;
+    }
+
+    //! Bytes taken by the member indices of this value and the values it contains.
+    size_t MemberIndexSize() const {
+        size_t size = 0;
+        if (IsObject()) {
+            size = MemberIndexBuckets(data_.o.capacity) * sizeof(MemberIndexBucket);
+            for (ConstMemberIterator m = MemberBegin(); m != MemberEnd(); ++m)
+                size += m->value.MemberIndexSize();
+        }
+        else if (IsArray()) {
+            for (const GenericValue* v = GetElementsPointer(); v != GetElementsPointer() + data_.a.size; ++v)
+                size += v->MemberIndexSize();
+        }
+        return size;
+    }
+
     //! Check whether a member exists in the object.
     /*!
         \param name Member name to be searched.
@@ -1218,6 +1315,9 @@ public:
     template <typename SourceAllocator>
     bool HasMember(const GenericValue<Encoding, SourceAllocator>& name) const { return FindMember(name) != MemberEnd(); }
 
+    //! Check whether a member exists in the object with a precomputed key.
+    bool HasMember(const GenericStaticKey<Ch>& key) const { return FindMember(key) != MemberEnd(); }
+
     //! Find member by name.
     /*!
         \param name Member name to be searched.
@@ -1254,6 +1354,8 @@ public:
     MemberIterator FindMember(const GenericValue<Encoding, SourceAllocator>& name) {
         RAPIDJSON_ASSERT(IsObject());
         RAPIDJSON_ASSERT(name.IsString());
+        if (MemberIndexBuckets(data_.o.capacity))
+            return MemberBegin() + FindIndexedMember(name.GetString(), name.GetStringLength(), internal::StrHash(name.GetString(), name.GetStringLength()));
         MemberIterator member = MemberBegin();
         for ( ; member != MemberEnd(); ++member)
             if (name.StringEqual(member->name))
@@ -1262,6 +1364,27 @@ public:
     }
     template <typename SourceAllocator> ConstMemberIterator FindMember(const GenericValue<Encoding, SourceAllocator>& name) const { return const_cast<GenericValue&>(*this).FindMember(name); }
 
+    //! Find member by precomputed key.
+    /*!
+        \param key Member name to be searched.
+        \pre IsObject() == true
+        \return Iterator to member, if it exists.
+            Otherwise returns \ref MemberEnd().
+        \note Linear time complexity, constant with a member index.
+    */
+    MemberIterator FindMember(const GenericStaticKey<Ch>& key) {
+        RAPIDJSON_ASSERT(IsObject());
+        if (MemberIndexBuckets(data_.o.capacity))
+            return MemberBegin() + FindIndexedMember(key.s, key.length, key.hash);
+        MemberIterator member = MemberBegin();
+        for ( ; member != MemberEnd(); ++member)
+            if (member->name.GetStringLength() == key.length &&
+                std::memcmp(member->name.GetString(), key.s, sizeof(Ch) * key.length) == 0)
+                break;
+        return member;
+    }
+    ConstMemberIterator FindMember(const GenericStaticKey<Ch>& key) const { return const_cast<GenericValue&>(*this).FindMember(key); }
+
 #if RAPIDJSON_HAS_STDSTRING
     //! Find member by string object name.
     /*!
@@ -1295,6 +1418,8 @@ public:
         members[o.size].name.RawAssign(name);
         members[o.size].value.RawAssign(value);
         o.size++;
+        if (MemberIndexBuckets(o.capacity))
+            IndexMember(o.size - 1);
         return *this;
     }
 
@@ -1431,6 +1556,7 @@ public:
         for (MemberIterator m = MemberBegin(); m != MemberEnd(); ++m)
             m->~Member();
         data_.o.size = 0;
+        BuildMemberIndexRaw();
     }
 
     //! Remove a member in object by its name.
@@ -1476,6 +1602,13 @@ public:
         RAPIDJSON_ASSERT(m >= MemberBegin() && m < MemberEnd());
 
         MemberIterator last(GetMembersPointer() + (data_.o.size - 1));
+        if (MemberIndexBuckets(data_.o.capacity)) {
+            const SizeType position = static_cast<SizeType>(m - MemberBegin());
+            const SizeType lastPosition = data_.o.size - 1;
+            EraseMemberIndexBucket(FindMemberIndexBucket(position, internal::StrHash(m->name.GetString(), m->name.GetStringLength())));
+            if (position != lastPosition)
+                GetMemberIndex()[FindMemberIndexBucket(lastPosition, internal::StrHash(last->name.GetString(), last->name.GetStringLength()))].position = position + 1;
+        }
         if (data_.o.size > 1 && m != last)
             *m = *last; // Move the last one to this place
         else
@@ -1519,6 +1652,7 @@ public:
             itr->~Member();
         std::memmove(static_cast<void*>(&*pos), &*last, static_cast<size_t>(MemberEnd() - last) * sizeof(Member));
         data_.o.size -= static_cast<SizeType>(last - first);
+        BuildMemberIndexRaw();
         return pos;
     }
 
@@ -2030,6 +2164,111 @@ private:
     RAPIDJSON_FORCEINLINE Member* GetMembersPointer() const { return RAPIDJSON_GETPOINTER(Member, data_.o.members); }
     RAPIDJSON_FORCEINLINE Member* SetMembersPointer(Member* members) { return RAPIDJSON_SETPOINTER(Member, data_.o.members, members); }
 
+    // Member index (RAPIDJSON_MEMBER_INDEX): an open-addressing hash table
+    // with linear probing that follows the members in the same allocation.
+    // It maps names to positions, so it survives reallocation as is and
+    // only changes when members are added, removed or moved.
+
+    //! Position of a member plus one (0 for a free bucket) and the hash of its name.
+    struct MemberIndexBucket {
+        SizeType position;
+        uint32_t hash;
+    };
+
+#if RAPIDJSON_MEMBER_INDEX
+    //! Buckets after \c capacity members: a power of two at least twice
+    //! the capacity, or none below the threshold.
+    static size_t MemberIndexBuckets(SizeType capacity) {
+        if (capacity < RAPIDJSON_MEMBER_INDEX_THRESHOLD)
+            return 0;
+        uint64_t buckets = static_cast<uint64_t>(capacity) * 2 - 1;
+        buckets |= buckets >> 1;
+        buckets |= buckets >> 2;
+        buckets |= buckets >> 4;
+        buckets |= buckets >> 8;
+        buckets |= buckets >> 16;
+        buckets |= buckets >> 32;
+        return static_cast<size_t>(buckets + 1);
+    }
+#else
+    static size_t MemberIndexBuckets(SizeType) { return 0; }
+#endif
+
+    //! Bytes of a members buffer with room for \c capacity members.
+    static size_t MembersSize(SizeType capacity) {
+        return capacity * sizeof(Member) + MemberIndexBuckets(capacity) * sizeof(MemberIndexBucket);
+    }
+
+    MemberIndexBucket* GetMemberIndex() const {
+        return reinterpret_cast<MemberIndexBucket*>(GetMembersPointer() + data_.o.capacity);
+    }
+
+    void IndexMember(SizeType position) {
+        const GenericValue& name = GetMembersPointer()[position].name;
+        const uint32_t hash = internal::StrHash(name.GetString(), name.GetStringLength());
+        MemberIndexBucket* buckets = GetMemberIndex();
+        const size_t mask = MemberIndexBuckets(data_.o.capacity) - 1;
+        size_t i = hash & mask;
+        while (buckets[i].position)
+            i = (i + 1) & mask;
+        buckets[i].position = position + 1;
+        buckets[i].hash = hash;
+    }
+
+    //! Indexes all members anew, if the object is large enough.
+    void BuildMemberIndexRaw() {
+        const size_t buckets = MemberIndexBuckets(data_.o.capacity);
+        if (!buckets)
+            return;
+        std::memset(static_cast<void*>(GetMemberIndex()), 0, buckets * sizeof(MemberIndexBucket));
+        for (SizeType i = 0; i < data_.o.size; i++)
+            IndexMember(i);
+    }
+
+    //! Position of the first member named [str, str + length), which hashes to \c hash, or the member count.
+    SizeType FindIndexedMember(const Ch* str, SizeType length, uint32_t hash) const {
+        const MemberIndexBucket* buckets = GetMemberIndex();
+        const size_t mask = MemberIndexBuckets(data_.o.capacity) - 1;
+        const Member* members = GetMembersPointer();
+        SizeType found = data_.o.size;
+        // Duplicate names may be probed in any order, so look at all of them.
+        for (size_t i = hash & mask; buckets[i].position; i = (i + 1) & mask) {
+            const SizeType position = buckets[i].position - 1;
+            if (buckets[i].hash == hash && position < found &&
+                members[position].name.GetStringLength() == length &&
+                std::memcmp(members[position].name.GetString(), str, sizeof(Ch) * length) == 0)
+                found = position;
+        }
+        return found;
+    }
+
+    //! Bucket of the member at \c position, whose name hashes to \c hash.
+    size_t FindMemberIndexBucket(SizeType position, uint32_t hash) const {
+        const MemberIndexBucket* buckets = GetMemberIndex();
+        const size_t mask = MemberIndexBuckets(data_.o.capacity) - 1;
+        size_t i = hash & mask;
+        while (buckets[i].position != position + 1) {
+            RAPIDJSON_ASSERT(buckets[i].position != 0);
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    //! Frees bucket \c i, moving back later entries of its probe sequence.
+    void EraseMemberIndexBucket(size_t i) {
+        MemberIndexBucket* buckets = GetMemberIndex();
+        const size_t mask = MemberIndexBuckets(data_.o.capacity) - 1;
+        for (size_t j = (i + 1) & mask; buckets[j].position; j = (j + 1) & mask) {
+            // An entry stays if its home bucket lies in (i, j].
+            const size_t home = buckets[j].hash & mask;
+            if (((j - home) & mask) >= ((j - i) & mask)) {
+                buckets[i] = buckets[j];
+                i = j;
+            }
+        }
+        buckets[i].position = 0;
+    }
+
     // Initialize this value as array with initial data, without calling destructor.
     void SetArrayRaw(GenericValue* values, SizeType count, Allocator& allocator) {
         data_.f.flags = kArrayFlag;
@@ -2047,13 +2286,14 @@ private:
     void SetObjectRaw(Member* members, SizeType count, Allocator& allocator) {
         data_.f.flags = kObjectFlag;
         if (count) {
-            Member* m = static_cast<Member*>(allocator.Malloc(count * sizeof(Member)));
+            Member* m = static_cast<Member*>(allocator.Malloc(MembersSize(count)));
             SetMembersPointer(m);
             std::memcpy(static_cast<void*>(m), members, count * sizeof(Member));
         }
         else
             SetMembersPointer(0);
         data_.o.size = data_.o.capacity = count;
+        BuildMemberIndexRaw();
     }
 
     //! Initialize this value as constant string, without calling destructor.
@@ -2109,6 +2349,9 @@ private:
 //! GenericValue with UTF8 encoding
 typedef GenericValue<UTF8<> > Value;
 
+//! GenericStaticKey for UTF8 member names.
+typedef GenericStaticKey<char> StaticKey;
+
 ///////////////////////////////////////////////////////////////////////////////
 // GenericDocument 
 
@@ -2589,6 +2832,7 @@ public:
     bool ObjectEmpty() const { return value_.ObjectEmpty(); }
     template <typename T> ValueType& operator[](T* name) const { return value_[name]; }
     template <typename SourceAllocator> ValueType& operator[](const GenericValue<EncodingType, SourceAllocator>& name) const { return value_[name]; }
+    ValueType& operator[](const GenericStaticKey<Ch>& key) const { return value_[key]; }
 #if RAPIDJSON_HAS_STDSTRING
     ValueType& operator[](const std::basic_string<Ch>& name) const { return value_[name]; }
 #endif
@@ -2600,8 +2844,10 @@ public:
     bool HasMember(const std::basic_string<Ch>& name) const { return value_.HasMember(name); }
 #endif
     template <typename SourceAllocator> bool HasMember(const GenericValue<EncodingType, SourceAllocator>& name) const { return value_.HasMember(name); }
+    bool HasMember(const GenericStaticKey<Ch>& key) const { return value_.HasMember(key); }
     MemberIterator FindMember(const Ch* name) const { return value_.FindMember(name); }
     template <typename SourceAllocator> MemberIterator FindMember(const GenericValue<EncodingType, SourceAllocator>& name) const { return value_.FindMember(name); }
+    MemberIterator FindMember(const GenericStaticKey<Ch>& key) const { return value_.FindMember(key); }
 #if RAPIDJSON_HAS_STDSTRING
     MemberIterator FindMember(const std::basic_string<Ch>& name) const { return value_.FindMember(name); }
 #endif
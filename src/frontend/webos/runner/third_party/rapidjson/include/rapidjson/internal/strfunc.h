@@ -45,6 +45,20 @@ inline SizeType StrLen(const wchar_t* s) {
     return SizeType(std::wcslen(s));
 }
 
+//! FNV-1a hash of the code units of a string.
+/*! Hashes member names for \ref RAPIDJSON_MEMBER_INDEX and GenericStaticKey.
+    Evaluated at compile time when \ref RAPIDJSON_CONSTEXPR is \c constexpr.
+*/
+template <typename Ch>
+inline RAPIDJSON_CONSTEXPR uint32_t StrHash(const Ch* s, SizeType length) {
+    uint32_t hash = 2166136261u;
+    for (SizeType i = 0; i < length; i++) {
+        hash ^= sizeof(Ch) == 1 ? static_cast<unsigned char>(s[i]) : static_cast<uint32_t>(s[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 //! Returns number of code points in a encoded string.
 template<typename Encoding>
 bool CountStringCodePoint(const typename Encoding::Ch* s, SizeType length, SizeType* outCount) {
@@ -288,6 +288,16 @@ public:
     }
 #endif
 
+    //! Append a name token from a precomputed key, and return a new Pointer
+    /*!
+        \param key Name of the token.
+        \param allocator Allocator for the newly return Pointer.
+        \return A new Pointer with appended token.
+    */
+    GenericPointer Append(const GenericStaticKey<Ch>& key, Allocator* allocator = 0) const {
+        return Append(key.s, key.length, allocator);
+    }
+
     //! Append a index token, and return a new Pointer
     /*!
         \param index Index to be appended.
@@ -348,11 +348,57 @@
     If any of these symbols is defined, RapidJSON defines the macro
     \c RAPIDJSON_SIMD to indicate the availability of the optimized code.
 */
+
+/*! \def RAPIDJSON_SIMD_DISPATCH
+    \ingroup RAPIDJSON_CONFIG
+    \brief Select the SIMD code at run time on x86-64.
+
+    Whitespace skipping and string scanning use the widest of SSE2 (16
+    bytes), AVX2 (32 bytes) and AVX-512BW (64 bytes) that the CPU supports,
+    detected once through CPUID. No -m compiler flags are needed.
+
+    Takes precedence over \c RAPIDJSON_SSE2 and \c RAPIDJSON_SSE42 in the
+    reader. Requires GCC or Clang, and is ignored on other targets.
+*/
+#if defined(RAPIDJSON_SIMD_DISPATCH) \
+    && !(defined(__x86_64__) && defined(__GNUC__))
+#undef RAPIDJSON_SIMD_DISPATCH
+#endif
+
 #if defined(RAPIDJSON_SSE2) || defined(RAPIDJSON_SSE42) \
-    || defined(RAPIDJSON_NEON) || defined(RAPIDJSON_DOXYGEN_RUNNING)
+    || defined(RAPIDJSON_NEON) || defined(RAPIDJSON_SIMD_DISPATCH) \
+    || defined(RAPIDJSON_DOXYGEN_RUNNING)
 #define RAPIDJSON_SIMD
 #endif
 
+///////////////////////////////////////////////////////////////////////////////
+// RAPIDJSON_MEMBER_INDEX
+
+/*! \def RAPIDJSON_MEMBER_INDEX
+    \ingroup RAPIDJSON_CONFIG
+    \brief Index the members of large objects by a hash of their names.
+
+    When defined to 1, an object with room for at least
+    \c RAPIDJSON_MEMBER_INDEX_THRESHOLD members keeps a hash table of its
+    member positions after the members, in the same allocation, and
+    GenericValue::FindMember() probes it instead of comparing every name.
+    Member order and iterators are unaffected. The table takes 16 to 32
+    bytes per member of capacity; see GenericValue::MemberIndexSize().
+
+    Defaults to 0, which leaves the object layout unchanged.
+*/
+#ifndef RAPIDJSON_MEMBER_INDEX
+#define RAPIDJSON_MEMBER_INDEX 0
+#endif
+
+/*! \def RAPIDJSON_MEMBER_INDEX_THRESHOLD
+    \ingroup RAPIDJSON_CONFIG
+    \brief Capacity from which objects are indexed, see \ref RAPIDJSON_MEMBER_INDEX.
+*/
+#ifndef RAPIDJSON_MEMBER_INDEX_THRESHOLD
+#define RAPIDJSON_MEMBER_INDEX_THRESHOLD 32
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 // RAPIDJSON_NO_SIZETYPEDEFINE
 
@@ -570,6 +616,28 @@ RAPIDJSON_NAMESPACE_END
 #define RAPIDJSON_NOEXCEPT /* noexcept */
 #endif // RAPIDJSON_HAS_CXX11_NOEXCEPT
 
+#ifndef RAPIDJSON_HAS_CXX11_THREADS
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900)
+#define RAPIDJSON_HAS_CXX11_THREADS 1
+#else
+#define RAPIDJSON_HAS_CXX11_THREADS 0
+#endif
+#endif // RAPIDJSON_HAS_CXX11_THREADS
+
+// constexpr functions with loops
+#ifndef RAPIDJSON_HAS_CXX14_CONSTEXPR
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201304
+#define RAPIDJSON_HAS_CXX14_CONSTEXPR 1
+#else
+#define RAPIDJSON_HAS_CXX14_CONSTEXPR 0
+#endif
+#endif
+#if RAPIDJSON_HAS_CXX14_CONSTEXPR
+#define RAPIDJSON_CONSTEXPR constexpr
+#else
+#define RAPIDJSON_CONSTEXPR /* constexpr */
+#endif // RAPIDJSON_HAS_CXX14_CONSTEXPR
+
 // no automatic detection, yet
 #ifndef RAPIDJSON_HAS_CXX11_TYPETRAITS
 #if (defined(_MSC_VER) && _MSC_VER >= 1700)
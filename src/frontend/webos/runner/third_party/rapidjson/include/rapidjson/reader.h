@@ -29,7 +29,9 @@
 #include <intrin.h>
 #pragma intrinsic(_BitScanForward)
 #endif
-#ifdef RAPIDJSON_SSE42
+#ifdef RAPIDJSON_SIMD_DISPATCH
+#include <immintrin.h>
+#elif defined(RAPIDJSON_SSE42)
 #include <nmmintrin.h>
 #elif defined(RAPIDJSON_SSE2)
 #include <emmintrin.h>
@@ -276,7 +278,290 @@ inline const char* SkipWhitespace(const char* p, const char* end) {
     return p;
 }
 
-#ifdef RAPIDJSON_SSE42
+#ifdef RAPIDJSON_SIMD_DISPATCH
+
+namespace internal {
+
+// The null-terminated kernels load whole aligned blocks, which never cross
+// a page boundary but may read before the start or past the end of the
+// buffer.
+#define RAPIDJSON_SIMD_NO_SANITIZE __attribute__((no_sanitize_address))
+#define RAPIDJSON_TARGET_AVX2 __attribute__((target("avx2")))
+#define RAPIDJSON_TARGET_AVX512BW __attribute__((target("avx512f,avx512bw")))
+
+inline bool IsWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// Bit i is set if byte i is whitespace.
+inline unsigned WhitespaceMaskSSE2(__m128i s) {
+    __m128i x = _mm_cmpeq_epi8(s, _mm_set1_epi8(' '));
+    x = _mm_or_si128(x, _mm_cmpeq_epi8(s, _mm_set1_epi8('\n')));
+    x = _mm_or_si128(x, _mm_cmpeq_epi8(s, _mm_set1_epi8('\r')));
+    x = _mm_or_si128(x, _mm_cmpeq_epi8(s, _mm_set1_epi8('\t')));
+    return static_cast<unsigned>(_mm_movemask_epi8(x));
+}
+
+// Bit i is set if byte i is '"', '\\' or below 0x20, i.e. ends an
+// unescaped run of a string.
+inline unsigned SpecialMaskSSE2(__m128i s) {
+    const __m128i sp = _mm_set1_epi8(0x1F);
+    const __m128i t1 = _mm_cmpeq_epi8(s, _mm_set1_epi8('\"'));
+    const __m128i t2 = _mm_cmpeq_epi8(s, _mm_set1_epi8('\\'));
+    const __m128i t3 = _mm_cmpeq_epi8(_mm_max_epu8(s, sp), sp); // s < 0x20 <=> max(s, 0x1F) == 0x1F
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(t1, t2), t3)));
+}
+
+RAPIDJSON_TARGET_AVX2 inline unsigned WhitespaceMaskAVX2(__m256i s) {
+    __m256i x = _mm256_cmpeq_epi8(s, _mm256_set1_epi8(' '));
+    x = _mm256_or_si256(x, _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\n')));
+    x = _mm256_or_si256(x, _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\r')));
+    x = _mm256_or_si256(x, _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\t')));
+    return static_cast<unsigned>(_mm256_movemask_epi8(x));
+}
+
+RAPIDJSON_TARGET_AVX2 inline unsigned SpecialMaskAVX2(__m256i s) {
+    const __m256i sp = _mm256_set1_epi8(0x1F);
+    const __m256i t1 = _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\"'));
+    const __m256i t2 = _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\\'));
+    const __m256i t3 = _mm256_cmpeq_epi8(_mm256_max_epu8(s, sp), sp);
+    return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(t1, t2), t3)));
+}
+
+RAPIDJSON_TARGET_AVX512BW inline uint64_t WhitespaceMaskAVX512(__m512i s) {
+    return _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8(' ')) |
+           _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\n')) |
+           _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\r')) |
+           _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\t'));
+}
+
+RAPIDJSON_TARGET_AVX512BW inline uint64_t SpecialMaskAVX512(__m512i s) {
+    return _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\"')) |
+           _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\\')) |
+           _mm512_cmple_epu8_mask(s, _mm512_set1_epi8(0x1F));
+}
+
+// Each kernel returns the first byte at or after p that is not whitespace
+// (SkipWhitespace*) or that ends an unescaped run (ScanUnescaped*). The
+// null-terminated forms start from the aligned block containing p and
+// mask off the bytes before it; the bounded forms stop at end.
+
+#define RAPIDJSON_SIMD_ALIGN_DOWN(p, n) \
+    reinterpret_cast<const char*>(reinterpret_cast<size_t>(p) & ~static_cast<size_t>(n - 1))
+
+RAPIDJSON_SIMD_NO_SANITIZE inline const char* SkipWhitespaceSSE2(const char* p) {
+    const char* base = RAPIDJSON_SIMD_ALIGN_DOWN(p, 16);
+    unsigned m = ~WhitespaceMaskSSE2(_mm_load_si128(reinterpret_cast<const __m128i*>(base))) &
+                 (0xFFFFu << (p - base)) & 0xFFFFu;
+    while (m == 0) {
+        base += 16;
+        m = ~WhitespaceMaskSSE2(_mm_load_si128(reinterpret_cast<const __m128i*>(base))) & 0xFFFFu;
+    }
+    return base + __builtin_ctz(m);
+}
+
+inline const char* SkipWhitespaceSSE2(const char* p, const char* end) {
+    for (; end - p >= 16; p += 16) {
+        unsigned m = ~WhitespaceMaskSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) & 0xFFFFu;
+        if (m != 0)
+            return p + __builtin_ctz(m);
+    }
+    while (p != end && IsWhitespace(*p))
+        ++p;
+    return p;
+}
+
+RAPIDJSON_SIMD_NO_SANITIZE inline const char* ScanUnescapedSSE2(const char* p) {
+    const char* base = RAPIDJSON_SIMD_ALIGN_DOWN(p, 16);
+    unsigned m = SpecialMaskSSE2(_mm_load_si128(reinterpret_cast<const __m128i*>(base))) &
+                 (0xFFFFu << (p - base));
+    while (m == 0) {
+        base += 16;
+        m = SpecialMaskSSE2(_mm_load_si128(reinterpret_cast<const __m128i*>(base)));
+    }
+    return base + __builtin_ctz(m);
+}
+
+inline const char* ScanUnescapedSSE2(const char* p, const char* end) {
+    for (; end - p >= 16; p += 16) {
+        unsigned m = SpecialMaskSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        if (m != 0)
+            return p + __builtin_ctz(m);
+    }
+    while (p != end && *p != '\"' && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20)
+        ++p;
+    return p;
+}
+
+RAPIDJSON_SIMD_NO_SANITIZE RAPIDJSON_TARGET_AVX2 inline const char* SkipWhitespaceAVX2(const char* p) {
+    const char* base = RAPIDJSON_SIMD_ALIGN_DOWN(p, 32);
+    unsigned m = ~WhitespaceMaskAVX2(_mm256_load_si256(reinterpret_cast<const __m256i*>(base))) &
+                 (~0u << (p - base));
+    while (m == 0) {
+        base += 32;
+        m = ~WhitespaceMaskAVX2(_mm256_load_si256(reinterpret_cast<const __m256i*>(base)));
+    }
+    return base + __builtin_ctz(m);
+}
+
+RAPIDJSON_TARGET_AVX2 inline const char* SkipWhitespaceAVX2(const char* p, const char* end) {
+    for (; end - p >= 32; p += 32) {
+        unsigned m = ~WhitespaceMaskAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+        if (m != 0)
+            return p + __builtin_ctz(m);
+    }
+    return SkipWhitespaceSSE2(p, end);
+}
+
+RAPIDJSON_SIMD_NO_SANITIZE RAPIDJSON_TARGET_AVX2 inline const char* ScanUnescapedAVX2(const char* p) {
+    const char* base = RAPIDJSON_SIMD_ALIGN_DOWN(p, 32);
+    unsigned m = SpecialMaskAVX2(_mm256_load_si256(reinterpret_cast<const __m256i*>(base))) &
+                 (~0u << (p - base));
+    while (m == 0) {
+        base += 32;
+        m = SpecialMaskAVX2(_mm256_load_si256(reinterpret_cast<const __m256i*>(base)));
+    }
+    return base + __builtin_ctz(m);
+}
+
+RAPIDJSON_TARGET_AVX2 inline const char* ScanUnescapedAVX2(const char* p, const char* end) {
+    for (; end - p >= 32; p += 32) {
+        unsigned m = SpecialMaskAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+        if (m != 0)
+            return p + __builtin_ctz(m);
+    }
+    return ScanUnescapedSSE2(p, end);
+}
+
+RAPIDJSON_SIMD_NO_SANITIZE RAPIDJSON_TARGET_AVX512BW inline const char* SkipWhitespaceAVX512(const char* p) {
+    const char* base = RAPIDJSON_SIMD_ALIGN_DOWN(p, 64);
+    uint64_t m = ~WhitespaceMaskAVX512(_mm512_load_si512(reinterpret_cast<const void*>(base))) &
+                 (~static_cast<uint64_t>(0) << (p - base));
+    while (m == 0) {
+        base += 64;
+        m = ~WhitespaceMaskAVX512(_mm512_load_si512(reinterpret_cast<const void*>(base)));
+    }
+    return base + __builtin_ctzll(m);
+}
+
+// The tail is read with a masked load, which does not fault on the bytes
+// left out.
+RAPIDJSON_TARGET_AVX512BW inline const char* SkipWhitespaceAVX512(const char* p, const char* end) {
+    for (; end - p >= 64; p += 64) {
+        uint64_t m = ~WhitespaceMaskAVX512(_mm512_loadu_si512(reinterpret_cast<const void*>(p)));
+        if (m != 0)
+            return p + __builtin_ctzll(m);
+    }
+    if (p == end)
+        return p;
+    const __mmask64 k = (static_cast<uint64_t>(1) << (end - p)) - 1;
+    const uint64_t m = ~WhitespaceMaskAVX512(_mm512_maskz_loadu_epi8(k, p)) & k;
+    return m != 0 ? p + __builtin_ctzll(m) : end;
+}
+
+RAPIDJSON_SIMD_NO_SANITIZE RAPIDJSON_TARGET_AVX512BW inline const char* ScanUnescapedAVX512(const char* p) {
+    const char* base = RAPIDJSON_SIMD_ALIGN_DOWN(p, 64);
+    uint64_t m = SpecialMaskAVX512(_mm512_load_si512(reinterpret_cast<const void*>(base))) &
+                 (~static_cast<uint64_t>(0) << (p - base));
+    while (m == 0) {
+        base += 64;
+        m = SpecialMaskAVX512(_mm512_load_si512(reinterpret_cast<const void*>(base)));
+    }
+    return base + __builtin_ctzll(m);
+}
+
+RAPIDJSON_TARGET_AVX512BW inline const char* ScanUnescapedAVX512(const char* p, const char* end) {
+    for (; end - p >= 64; p += 64) {
+        uint64_t m = SpecialMaskAVX512(_mm512_loadu_si512(reinterpret_cast<const void*>(p)));
+        if (m != 0)
+            return p + __builtin_ctzll(m);
+    }
+    if (p == end)
+        return p;
+    const __mmask64 k = (static_cast<uint64_t>(1) << (end - p)) - 1;
+    const uint64_t m = SpecialMaskAVX512(_mm512_maskz_loadu_epi8(k, p)) & k;
+    return m != 0 ? p + __builtin_ctzll(m) : end;
+}
+
+#undef RAPIDJSON_SIMD_ALIGN_DOWN
+#undef RAPIDJSON_TARGET_AVX512BW
+#undef RAPIDJSON_TARGET_AVX2
+#undef RAPIDJSON_SIMD_NO_SANITIZE
+
+//! Instruction sets selectable by RAPIDJSON_SIMD_DISPATCH.
+enum SimdLevel {
+    kSimdSSE2,      //!< 16 bytes at a time, always available on x86-64.
+    kSimdAVX2,      //!< 32 bytes at a time.
+    kSimdAVX512BW   //!< 64 bytes at a time.
+};
+
+struct SimdKernels {
+    const char* (*skipWhitespace)(const char* p);
+    const char* (*skipWhitespaceBounded)(const char* p, const char* end);
+    const char* (*scanUnescaped)(const char* p);
+    const char* (*scanUnescapedBounded)(const char* p, const char* end);
+};
+
+//! The widest level supported by both the CPU and the OS.
+inline SimdLevel DetectSimdLevel() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw"))
+        return kSimdAVX512BW;
+    if (__builtin_cpu_supports("avx2"))
+        return kSimdAVX2;
+    return kSimdSSE2;
+}
+
+inline SimdKernels GetSimdKernels(SimdLevel level) {
+    SimdKernels kernels;
+    switch (level) {
+    case kSimdAVX512BW:
+        kernels.skipWhitespace = &SkipWhitespaceAVX512;
+        kernels.skipWhitespaceBounded = &SkipWhitespaceAVX512;
+        kernels.scanUnescaped = &ScanUnescapedAVX512;
+        kernels.scanUnescapedBounded = &ScanUnescapedAVX512;
+        break;
+    case kSimdAVX2:
+        kernels.skipWhitespace = &SkipWhitespaceAVX2;
+        kernels.skipWhitespaceBounded = &SkipWhitespaceAVX2;
+        kernels.scanUnescaped = &ScanUnescapedAVX2;
+        kernels.scanUnescapedBounded = &ScanUnescapedAVX2;
+        break;
+    default:
+        kernels.skipWhitespace = &SkipWhitespaceSSE2;
+        kernels.skipWhitespaceBounded = &SkipWhitespaceSSE2;
+        kernels.scanUnescaped = &ScanUnescapedSSE2;
+        kernels.scanUnescapedBounded = &ScanUnescapedSSE2;
+        break;
+    }
+    return kernels;
+}
+
+//! Kernels used by the reader, selected on first use. May be replaced,
+//! e.g. by GetSimdKernels(kSimdSSE2) to compare against the baseline.
+inline SimdKernels& SimdDispatch() {
+    static SimdKernels kernels = GetSimdKernels(DetectSimdLevel());
+    return kernels;
+}
+
+} // namespace internal
+
+//! Skip whitespace with the widest of SSE2, AVX2 and AVX-512BW the CPU supports.
+inline const char *SkipWhitespace_SIMD(const char* p) {
+    // Fast return for single non-whitespace
+    if (!internal::IsWhitespace(*p))
+        return p;
+    return internal::SimdDispatch().skipWhitespace(p + 1);
+}
+
+inline const char *SkipWhitespace_SIMD(const char* p, const char* end) {
+    // Fast return for single non-whitespace
+    if (p == end || !internal::IsWhitespace(*p))
+        return p;
+    return internal::SimdDispatch().skipWhitespaceBounded(p + 1, end);
+}
+
+#elif defined(RAPIDJSON_SSE42)
 //! Skip whitespace with SSE 4.2 pcmpistrm instruction, testing 16 8-byte characters at once.
 inline const char *SkipWhitespace_SIMD(const char* p) {
     // Fast return for single non-whitespace
@@ -512,6 +797,10 @@ template<> inline void SkipWhitespace(StringStream& is) {
 template<> inline void SkipWhitespace(EncodedInputStream<UTF8<>, MemoryStream>& is) {
     is.is_.src_ = SkipWhitespace_SIMD(is.is_.src_, is.is_.end_);
 }
+
+template<> inline void SkipWhitespace(MemoryStream& is) {
+    is.src_ = SkipWhitespace_SIMD(is.src_, is.end_);
+}
 #endif // RAPIDJSON_SIMD
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1058,7 +1347,38 @@ private:
             // Do nothing for generic version
     }
 
-#if defined(RAPIDJSON_SSE2) || defined(RAPIDJSON_SSE42)
+#if defined(RAPIDJSON_SIMD_DISPATCH)
+    // StringStream -> StackStream<char>
+    static RAPIDJSON_FORCEINLINE void ScanCopyUnescapedString(StringStream& is, StackStream<char>& os) {
+        const char* p = is.src_;
+        const char* q = internal::SimdDispatch().scanUnescaped(p);
+        if (q != p)
+            std::memcpy(os.Push(static_cast<SizeType>(q - p)), p, static_cast<size_t>(q - p));
+        is.src_ = q;
+    }
+
+    // MemoryStream -> StackStream<char>
+    static RAPIDJSON_FORCEINLINE void ScanCopyUnescapedString(MemoryStream& is, StackStream<char>& os) {
+        const char* p = is.src_;
+        const char* q = internal::SimdDispatch().scanUnescapedBounded(p, is.end_);
+        if (q != p)
+            std::memcpy(os.Push(static_cast<SizeType>(q - p)), p, static_cast<size_t>(q - p));
+        is.src_ = q;
+    }
+
+    // InsituStringStream -> InsituStringStream
+    static RAPIDJSON_FORCEINLINE void ScanCopyUnescapedString(InsituStringStream& is, InsituStringStream& os) {
+        RAPIDJSON_ASSERT(&is == &os);
+        (void)os;
+
+        char* p = is.src_;
+        char* q = const_cast<char*>(internal::SimdDispatch().scanUnescaped(p));
+        if (is.dst_ != p)   // Earlier escapes shifted the output behind the input
+            std::memmove(is.dst_, p, static_cast<size_t>(q - p));
+        is.dst_ += q - p;
+        is.src_ = q;
+    }
+#elif defined(RAPIDJSON_SSE2) || defined(RAPIDJSON_SSE42)
     // StringStream -> StackStream<char>
     static RAPIDJSON_FORCEINLINE void ScanCopyUnescapedString(StringStream& is, StackStream<char>& os) {
         const char* p = is.src_;
@@ -0,0 +1,966 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef RAPIDJSON_STRUCTURALREADER_H_
+#define RAPIDJSON_STRUCTURALREADER_H_
+
+/*! \file structuralreader.h */
+
+#include "reader.h"
+#include "document.h"
+#include "memorystream.h"
+#include <cstring>
+
+#if defined(RAPIDJSON_SSE2) || defined(RAPIDJSON_SSE42) || defined(RAPIDJSON_SIMD_DISPATCH)
+#define RAPIDJSON_STRUCTURAL_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef RAPIDJSON_SIMD_DISPATCH
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(effc++)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+
+namespace internal {
+
+inline unsigned CountTrailingZeros64(uint64_t x) {
+    RAPIDJSON_ASSERT(x != 0);
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long r;
+    _BitScanForward64(&r, x);
+    return static_cast<unsigned>(r);
+#elif defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+    unsigned r = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        ++r;
+    }
+    return r;
+#endif
+}
+
+//! Character classes of a 64-byte block, bit i for byte i.
+struct StructuralBlock {
+    uint64_t whitespace;    //!< ' ', '\\t', '\\n', '\\r'
+    uint64_t op;            //!< '{', '}', '[', ']', ':', ',' and possibly other bytes below 0x20
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t control;       //!< below 0x20
+};
+
+//! Characters escaped by a backslash. \c carry is set when the block ends
+//! with a backslash that escapes the first character of the next one.
+inline uint64_t FindEscaped(uint64_t backslash, uint64_t& carry) {
+    uint64_t escaped = carry;
+    backslash &= ~carry;
+    carry = 0;
+    while (backslash) {
+        const unsigned i = CountTrailingZeros64(backslash);
+        if (i == 63) {
+            carry = 1;
+            break;
+        }
+        escaped |= static_cast<uint64_t>(2) << i;
+        backslash &= ~(static_cast<uint64_t>(3) << i);
+    }
+    return escaped;
+}
+
+//! Portable stage one primitives, with SSE2 where the reader uses SIMD.
+struct StructuralGeneric {
+#ifdef RAPIDJSON_STRUCTURAL_SSE2
+    static void Classify(const char* p, StructuralBlock& b) {
+        b.whitespace = b.op = b.quote = b.backslash = b.control = 0;
+        const __m128i sp = _mm_set1_epi8(0x1F);
+        for (unsigned k = 0; k < 64; k += 16) {
+            const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + k));
+            // '[' | 0x20 == '{' and ']' | 0x20 == '}'
+            const __m128i folded = _mm_or_si128(s, _mm_set1_epi8(0x20));
+            __m128i ws = _mm_cmpeq_epi8(s, _mm_set1_epi8(' '));
+            ws = _mm_or_si128(ws, _mm_cmpeq_epi8(s, _mm_set1_epi8('\t')));
+            ws = _mm_or_si128(ws, _mm_cmpeq_epi8(s, _mm_set1_epi8('\n')));
+            ws = _mm_or_si128(ws, _mm_cmpeq_epi8(s, _mm_set1_epi8('\r')));
+            __m128i op = _mm_cmpeq_epi8(folded, _mm_set1_epi8('{'));
+            op = _mm_or_si128(op, _mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+            op = _mm_or_si128(op, _mm_cmpeq_epi8(s, _mm_set1_epi8(':')));
+            op = _mm_or_si128(op, _mm_cmpeq_epi8(s, _mm_set1_epi8(',')));
+            b.whitespace |= static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(ws))) << k;
+            b.op |= static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(op))) << k;
+            b.quote |= static_cast<uint64_t>(static_cast<unsigned>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(s, _mm_set1_epi8('\"'))))) << k;
+            b.backslash |= static_cast<uint64_t>(static_cast<unsigned>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(s, _mm_set1_epi8('\\'))))) << k;
+            b.control |= static_cast<uint64_t>(static_cast<unsigned>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(s, sp), sp)))) << k;
+        }
+    }
+#else
+    static void Classify(const char* p, StructuralBlock& b) {
+        b.whitespace = b.op = b.quote = b.backslash = b.control = 0;
+        for (unsigned k = 0; k < 64; k++) {
+            const unsigned char c = static_cast<unsigned char>(p[k]);
+            const uint64_t bit = static_cast<uint64_t>(1) << k;
+            switch (c) {
+            case ' ': case '\t': case '\n': case '\r':
+                b.whitespace |= bit; break;
+            case '{': case '}': case '[': case ']': case ':': case ',':
+                b.op |= bit; break;
+            case '\"':
+                b.quote |= bit; break;
+            case '\\':
+                b.backslash |= bit; break;
+            default:
+                break;
+            }
+            if (c < 0x20)
+                b.control |= bit;
+        }
+    }
+#endif
+
+    //! Bit i is the parity of the bits 0..i of x.
+    static uint64_t PrefixXor(uint64_t x) {
+        x ^= x << 1;
+        x ^= x << 2;
+        x ^= x << 4;
+        x ^= x << 8;
+        x ^= x << 16;
+        x ^= x << 32;
+        return x;
+    }
+
+    static uint32_t* Flatten(uint32_t* out, uint32_t base, uint64_t bits) {
+        while (bits) {
+            *out++ = base + CountTrailingZeros64(bits);
+            bits &= bits - 1;
+        }
+        return out;
+    }
+};
+
+#ifdef RAPIDJSON_SIMD_DISPATCH
+
+#define RAPIDJSON_TARGET_AVX2 __attribute__((target("avx2,bmi,popcnt,pclmul")))
+#define RAPIDJSON_TARGET_AVX512BW __attribute__((target("avx512f,avx512bw,bmi,popcnt,pclmul")))
+
+// Table lookups on the low nibble, as in simdjson: a byte is whitespace if
+// it equals its entry in the first table, and an operator if its entry in
+// the second one equals the byte with 0x20 set. The latter also matches
+// 0x0C and 0x1A, which are invalid outside strings either way.
+#define RAPIDJSON_STRUCTURAL_TABLES(set) \
+    set(whitespaceTable, ' ', 100, 100, 100, 17, 100, 113, 2, 100, '\t', '\n', 112, 100, '\r', 100, 100); \
+    set(opTable, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, ':', '{', ',', '}', 0, 0)
+
+struct StructuralSIMD {
+    RAPIDJSON_TARGET_AVX2 static uint64_t PrefixXor(uint64_t x) {
+        return static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_clmulepi64_si128(
+            _mm_set_epi64x(0, static_cast<long long>(x)), _mm_set1_epi8(static_cast<char>(0xFF)), 0)));
+    }
+
+    //! Writes the positions four at a time; needs three spare entries.
+    RAPIDJSON_TARGET_AVX2 static uint32_t* Flatten(uint32_t* out, uint32_t base, uint64_t bits) {
+        uint32_t* const end = out + _mm_popcnt_u64(bits);
+        while (bits) {
+            out[0] = base + static_cast<uint32_t>(_tzcnt_u64(bits));
+            bits = _blsr_u64(bits);
+            out[1] = base + static_cast<uint32_t>(_tzcnt_u64(bits));
+            bits = _blsr_u64(bits);
+            out[2] = base + static_cast<uint32_t>(_tzcnt_u64(bits));
+            bits = _blsr_u64(bits);
+            out[3] = base + static_cast<uint32_t>(_tzcnt_u64(bits));
+            bits = _blsr_u64(bits);
+            out += 4;
+        }
+        return end;
+    }
+};
+
+struct StructuralAVX2 : StructuralSIMD {
+    RAPIDJSON_TARGET_AVX2 static void Classify(const char* p, StructuralBlock& b) {
+#define RAPIDJSON_SET(name, ...) const __m256i name = _mm256_setr_epi8(__VA_ARGS__, __VA_ARGS__)
+        RAPIDJSON_STRUCTURAL_TABLES(RAPIDJSON_SET);
+#undef RAPIDJSON_SET
+        b.whitespace = b.op = b.quote = b.backslash = b.control = 0;
+        const __m256i sp = _mm256_set1_epi8(0x1F);
+        for (unsigned k = 0; k < 64; k += 32) {
+            const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + k));
+            const __m256i ws = _mm256_cmpeq_epi8(_mm256_shuffle_epi8(whitespaceTable, s), s);
+            const __m256i op = _mm256_cmpeq_epi8(_mm256_shuffle_epi8(opTable, s),
+                                                 _mm256_or_si256(s, _mm256_set1_epi8(0x20)));
+            b.whitespace |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(ws))) << k;
+            b.op |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(op))) << k;
+            b.quote |= static_cast<uint64_t>(static_cast<uint32_t>(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi8(s, _mm256_set1_epi8('\"'))))) << k;
+            b.backslash |= static_cast<uint64_t>(static_cast<uint32_t>(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi8(s, _mm256_set1_epi8('\\'))))) << k;
+            b.control |= static_cast<uint64_t>(static_cast<uint32_t>(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(s, sp), sp)))) << k;
+        }
+    }
+};
+
+struct StructuralAVX512 : StructuralSIMD {
+    RAPIDJSON_TARGET_AVX512BW static void Classify(const char* p, StructuralBlock& b) {
+#define RAPIDJSON_SET(name, ...) \
+        static const char name##Bytes[64] = { __VA_ARGS__, __VA_ARGS__, __VA_ARGS__, __VA_ARGS__ }; \
+        const __m512i name = _mm512_loadu_si512(name##Bytes)
+        RAPIDJSON_STRUCTURAL_TABLES(RAPIDJSON_SET);
+#undef RAPIDJSON_SET
+        const __m512i s = _mm512_loadu_si512(p);
+        b.whitespace = _mm512_cmpeq_epi8_mask(_mm512_shuffle_epi8(whitespaceTable, s), s);
+        b.op = _mm512_cmpeq_epi8_mask(_mm512_shuffle_epi8(opTable, s), _mm512_or_si512(s, _mm512_set1_epi8(0x20)));
+        b.quote = _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\"'));
+        b.backslash = _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\\'));
+        b.control = _mm512_cmple_epu8_mask(s, _mm512_set1_epi8(0x1F));
+    }
+};
+
+#undef RAPIDJSON_STRUCTURAL_TABLES
+
+#endif // RAPIDJSON_SIMD_DISPATCH
+
+//! Stage one: writes the structural positions of the text to \c out, each
+//! position of brackets, braces, colons, commas and quotes outside strings
+//! and of the first character of every other token, and to \c dirty one
+//! bit per byte for backslashes and control characters inside strings.
+//! \c out needs room for length + 4 entries. Returns the number of
+//! positions written.
+template <typename Primitives>
+inline size_t IndexStructurals(const char* json, size_t length, uint32_t* out, uint64_t* dirty) {
+    uint32_t* const begin = out;
+    uint64_t escapeCarry = 0;   // next block starts with an escaped character
+    uint64_t stringCarry = 0;   // all ones if the next block starts inside a string
+    uint64_t scalarCarry = 0;   // next block starts right after a scalar character
+    for (size_t base = 0; base < length; base += 64) {
+        StructuralBlock b;
+        const size_t left = length - base;
+        uint64_t valid = ~static_cast<uint64_t>(0);
+        if (RAPIDJSON_LIKELY(left >= 64))
+            Primitives::Classify(json + base, b);
+        else {
+            char tail[64];
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, json + base, left);
+            Primitives::Classify(tail, b);
+            valid = (static_cast<uint64_t>(1) << left) - 1;
+        }
+
+        const uint64_t escaped = b.backslash | escapeCarry ? FindEscaped(b.backslash, escapeCarry) : 0;
+        const uint64_t quotes = b.quote & ~escaped;
+        // Set from an opening quote up to, not including, its closing quote.
+        const uint64_t inString = Primitives::PrefixXor(quotes) ^ stringCarry;
+        stringCarry = static_cast<uint64_t>(0) - (inString >> 63);
+
+        // Tokens other than strings start at a scalar character that
+        // does not follow another one.
+        const uint64_t scalar = ~(b.op | b.whitespace) & ~quotes;
+        const uint64_t follows = (scalar << 1) | scalarCarry;
+        scalarCarry = scalar >> 63;
+
+        const uint64_t structurals = (((b.op | (scalar & ~follows)) & ~inString) | quotes) & valid;
+        dirty[base / 64] = (b.backslash | b.control) & inString & valid;
+        out = Primitives::Flatten(out, static_cast<uint32_t>(base), structurals);
+    }
+    *out++ = static_cast<uint32_t>(length);
+    return static_cast<size_t>(out - begin);
+}
+
+typedef size_t (*StructuralIndexer)(const char* json, size_t length, uint32_t* out, uint64_t* dirty);
+
+inline size_t IndexStructuralsGeneric(const char* json, size_t length, uint32_t* out, uint64_t* dirty) {
+    return IndexStructurals<StructuralGeneric>(json, length, out, dirty);
+}
+
+#ifdef RAPIDJSON_SIMD_DISPATCH
+
+RAPIDJSON_TARGET_AVX2 __attribute__((flatten))
+inline size_t IndexStructuralsAVX2(const char* json, size_t length, uint32_t* out, uint64_t* dirty) {
+    return IndexStructurals<StructuralAVX2>(json, length, out, dirty);
+}
+
+RAPIDJSON_TARGET_AVX512BW __attribute__((flatten))
+inline size_t IndexStructuralsAVX512(const char* json, size_t length, uint32_t* out, uint64_t* dirty) {
+    return IndexStructurals<StructuralAVX512>(json, length, out, dirty);
+}
+
+#undef RAPIDJSON_TARGET_AVX512BW
+#undef RAPIDJSON_TARGET_AVX2
+
+inline StructuralIndexer GetStructuralIndexer(SimdLevel level) {
+    __builtin_cpu_init();
+    // PCLMUL and BMI1 come with every AVX2 CPU in practice, but check.
+    if (!__builtin_cpu_supports("pclmul") || !__builtin_cpu_supports("bmi"))
+        return &IndexStructuralsGeneric;
+    switch (level) {
+    case kSimdAVX512BW:
+        return &IndexStructuralsAVX512;
+    case kSimdAVX2:
+        return &IndexStructuralsAVX2;
+    default:
+        return &IndexStructuralsGeneric;
+    }
+}
+
+//! Stage one used by GenericStructuralReader, selected on first use like
+//! SimdDispatch().
+inline StructuralIndexer& StructuralDispatch() {
+    static StructuralIndexer indexer = GetStructuralIndexer(DetectSimdLevel());
+    return indexer;
+}
+
+#endif // RAPIDJSON_SIMD_DISPATCH
+
+} // namespace internal
+
+///////////////////////////////////////////////////////////////////////////////
+// GenericStructuralReader
+
+//! Two-stage JSON parser producing the same SAX events as GenericReader.
+/*! Stage one classifies the text 64 bytes at a time (SSE2 where the
+    reader's SIMD code is enabled, AVX2 or AVX-512BW when available with
+    RAPIDJSON_SIMD_DISPATCH) into an index of structural positions:
+    brackets, braces, colons, commas and quotes outside strings, plus the
+    first character of every other token. Stage two walks the index with
+    an explicit stack instead of scanning the text byte by byte.
+
+    Strings, null, booleans and integers of up to nine digits are handled
+    from the index. Everything else (other numbers, malformed tokens and
+    strings with invalid escapes or control characters) is handed to a
+    GenericReader positioned on the token, so values, error codes and error
+    offsets are those of GenericReader. Stage two never recurses, so
+    \c kParseIterativeFlag has no effect; errors are reported as by the
+    recursive parser.
+
+    \c kParseCommentsFlag and texts of 4 GiB or more are parsed by
+    GenericReader alone. The index takes up to four bytes per byte of text.
+    Without SIMD, stage one is slower than GenericReader's own scanning.
+
+    \tparam SourceEncoding Encoding of the input, one byte per code unit.
+    \tparam TargetEncoding Encoding of the parse output.
+    \tparam StackAllocator Allocator of the index and the stacks.
+*/
+template <typename SourceEncoding, typename TargetEncoding, typename StackAllocator = CrtAllocator>
+class GenericStructuralReader {
+public:
+    typedef typename SourceEncoding::Ch Ch; //!< SourceEncoding character type
+    typedef GenericReader<SourceEncoding, TargetEncoding, StackAllocator> ReaderType;
+
+    //! Constructor.
+    /*! \param stackAllocator Optional allocator for the index and the stacks.
+        \param stackCapacity Initial capacity of each stack in bytes.
+    */
+    GenericStructuralReader(StackAllocator* stackAllocator = 0, size_t stackCapacity = kDefaultStackCapacity) :
+        reader_(stackAllocator, stackCapacity), positions_(stackAllocator, stackCapacity),
+        dirty_(stackAllocator, stackCapacity), containers_(stackAllocator, stackCapacity),
+        stack_(stackAllocator, stackCapacity), parseResult_() {}
+
+    //! Parse a null-terminated JSON text.
+    template <unsigned parseFlags, typename Handler>
+    ParseResult Parse(const Ch* str, Handler& handler) {
+        return ParseText<parseFlags>(str, handler);
+    }
+
+    //! Parse \c length bytes of JSON text, as from a MemoryStream.
+    template <unsigned parseFlags, typename Handler>
+    ParseResult Parse(const Ch* str, size_t length, Handler& handler) {
+        return ParseMemory<parseFlags>(str, length, handler);
+    }
+
+    //! Parse a null-terminated JSON text in place (kParseInsituFlag is implied).
+    template <unsigned parseFlags, typename Handler>
+    ParseResult ParseInsitu(Ch* str, Handler& handler) {
+        return ParseText<parseFlags | kParseInsituFlag>(str, handler);
+    }
+
+    //! Parse a null-terminated JSON text into \c document.
+    /*! Like GenericDocument::Parse(), \c document is left unchanged on error. */
+    template <unsigned parseFlags, typename Allocator, typename DocumentStackAllocator>
+    ParseResult Parse(const Ch* str, GenericDocument<TargetEncoding, Allocator, DocumentStackAllocator>& document) {
+        TextGenerator<parseFlags> generator(*this, str);
+        document.Populate(generator);
+        return parseResult_;
+    }
+
+    //! Parse \c length bytes of JSON text into \c document.
+    template <unsigned parseFlags, typename Allocator, typename DocumentStackAllocator>
+    ParseResult Parse(const Ch* str, size_t length, GenericDocument<TargetEncoding, Allocator, DocumentStackAllocator>& document) {
+        MemoryGenerator<parseFlags> generator(*this, str, length);
+        document.Populate(generator);
+        return parseResult_;
+    }
+
+    //! Parse a null-terminated JSON text in place into \c document.
+    template <unsigned parseFlags, typename Allocator, typename DocumentStackAllocator>
+    ParseResult ParseInsitu(Ch* str, GenericDocument<TargetEncoding, Allocator, DocumentStackAllocator>& document) {
+        InsituGenerator<parseFlags> generator(*this, str);
+        document.Populate(generator);
+        return parseResult_;
+    }
+
+    //! Whether a parse error has occurred in the last parsing.
+    bool HasParseError() const { return parseResult_.IsError(); }
+
+    //! Get the \ref ParseErrorCode of last parsing.
+    ParseErrorCode GetParseErrorCode() const { return parseResult_.Code(); }
+
+    //! Get the position of last parsing error in input, 0 otherwise.
+    size_t GetErrorOffset() const { return parseResult_.Offset(); }
+
+private:
+    // Prohibit copy constructor & assignment operator.
+    GenericStructuralReader(const GenericStructuralReader&);
+    GenericStructuralReader& operator=(const GenericStructuralReader&);
+
+    typedef typename TargetEncoding::Ch TargetCh;
+
+    template <unsigned parseFlags, typename Handler>
+    ParseResult ParseText(const Ch* str, Handler& handler) {
+        RAPIDJSON_ASSERT(!(parseFlags & kParseInsituFlag));
+        GenericStringStream<SourceEncoding> is(str);
+        Input<GenericStringStream<SourceEncoding>, const Ch*, true> input(is, str, std::strlen(str));
+        return ParseInput<parseFlags>(input, handler);
+    }
+
+    template <unsigned parseFlags, typename Handler>
+    ParseResult ParseText(Ch* str, Handler& handler) {
+        GenericInsituStringStream<SourceEncoding> is(str);
+        Input<GenericInsituStringStream<SourceEncoding>, Ch*, true> input(is, str, std::strlen(str));
+        return ParseInput<parseFlags>(input, handler);
+    }
+
+    template <unsigned parseFlags, typename Handler>
+    ParseResult ParseMemory(const Ch* str, size_t length, Handler& handler) {
+        RAPIDJSON_STATIC_ASSERT(sizeof(Ch) == 1);
+        RAPIDJSON_ASSERT(!(parseFlags & kParseInsituFlag));
+        MemoryStream is(reinterpret_cast<const char*>(str), length);
+        // A NUL ends the text for GenericReader as well.
+        const void* nul = length ? std::memchr(str, '\0', length) : 0;
+        Input<MemoryStream, const Ch*, false> input(is, str, nul ? static_cast<size_t>(static_cast<const Ch*>(nul) - str) : length);
+        return ParseInput<parseFlags>(input, handler);
+    }
+
+    //! The text and the stream GenericReader reads tokens from.
+    /*! \tparam terminated Whether the text is followed by a NUL. Reads are
+        at most one past the end of the text.
+    */
+    template <typename Stream, typename CharPtr, bool terminated>
+    struct Input {
+        Input(Stream& s, CharPtr b, size_t n) : stream(s), base(b), length(n) {}
+        Ch At(size_t pos) const { return terminated || pos < length ? base[pos] : Ch('\0'); }
+
+        Stream& stream;
+        CharPtr base;
+        size_t length;
+    };
+
+    struct Container {
+        SizeType count;
+        bool object;
+    };
+
+    //! Routes the string GenericReader parses for a key to Handler::Key().
+    template <typename Handler>
+    struct KeyHandler {
+        explicit KeyHandler(Handler& h) : handler(h) {}
+        bool String(const TargetCh* str, SizeType length, bool copy) { return handler.Key(str, length, copy); }
+        // Not reached: GenericReader only sees the string.
+        bool Null() { return false; }
+        bool Bool(bool) { return false; }
+        bool Int(int) { return false; }
+        bool Uint(unsigned) { return false; }
+        bool Int64(int64_t) { return false; }
+        bool Uint64(uint64_t) { return false; }
+        bool Double(double) { return false; }
+        bool RawNumber(const TargetCh*, SizeType, bool) { return false; }
+        bool StartObject() { return false; }
+        bool Key(const TargetCh*, SizeType, bool) { return false; }
+        bool EndObject(SizeType) { return false; }
+        bool StartArray() { return false; }
+        bool EndArray(SizeType) { return false; }
+
+        Handler& handler;
+    private:
+        KeyHandler& operator=(const KeyHandler&);
+    };
+
+    template <unsigned parseFlags>
+    struct TextGenerator {
+        TextGenerator(GenericStructuralReader& r, const Ch* s) : reader(r), str(s) {}
+        template <typename Handler>
+        bool operator()(Handler& handler) { return !reader.template ParseText<parseFlags>(str, handler).IsError(); }
+        GenericStructuralReader& reader;
+        const Ch* str;
+    private:
+        TextGenerator& operator=(const TextGenerator&);
+    };
+
+    template <unsigned parseFlags>
+    struct MemoryGenerator {
+        MemoryGenerator(GenericStructuralReader& r, const Ch* s, size_t n) : reader(r), str(s), length(n) {}
+        template <typename Handler>
+        bool operator()(Handler& handler) { return !reader.template ParseMemory<parseFlags>(str, length, handler).IsError(); }
+        GenericStructuralReader& reader;
+        const Ch* str;
+        size_t length;
+    private:
+        MemoryGenerator& operator=(const MemoryGenerator&);
+    };
+
+    template <unsigned parseFlags>
+    struct InsituGenerator {
+        InsituGenerator(GenericStructuralReader& r, Ch* s) : reader(r), str(s) {}
+        template <typename Handler>
+        bool operator()(Handler& handler) { return !reader.template ParseText<parseFlags | kParseInsituFlag>(str, handler).IsError(); }
+        GenericStructuralReader& reader;
+        Ch* str;
+    private:
+        InsituGenerator& operator=(const InsituGenerator&);
+    };
+
+    // clear stacks on any exit from ParseInput, e.g. due to exception
+    struct ClearStacksOnExit {
+        explicit ClearStacksOnExit(GenericStructuralReader& r) : r_(r) {}
+        ~ClearStacksOnExit() {
+            r_.positions_.Clear();
+            r_.dirty_.Clear();
+            r_.containers_.Clear();
+            r_.stack_.Clear();
+        }
+    private:
+        GenericStructuralReader& r_;
+        ClearStacksOnExit(const ClearStacksOnExit&);
+        ClearStacksOnExit& operator=(const ClearStacksOnExit&);
+    };
+
+    static bool IsWhitespace(Ch c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+    // Only used with kParseInsituFlag, where the text is mutable.
+    static Ch* Mutable(Ch* p) { return p; }
+    static Ch* Mutable(const Ch* p) { RAPIDJSON_ASSERT(false); return const_cast<Ch*>(p); }
+
+    // Stage one: fills positions_ with the structural positions, ending
+    // with length itself, and dirty_ with a bitmap of backslashes and
+    // control characters inside strings.
+    void BuildIndex(const Ch* text, size_t length) {
+        const size_t capacity = length + 4;
+        uint32_t* out = positions_.template Push<uint32_t>(capacity);
+        uint64_t* dirty = dirty_.template Push<uint64_t>(length / 64 + 1);
+#ifdef RAPIDJSON_SIMD_DISPATCH
+        const size_t count = internal::StructuralDispatch()(reinterpret_cast<const char*>(text), length, out, dirty);
+#else
+        const size_t count = internal::IndexStructuralsGeneric(reinterpret_cast<const char*>(text), length, out, dirty);
+#endif
+        positions_.template Pop<uint32_t>(capacity - count);
+    }
+
+    //! First position in [first, last) with a dirty bit, or \c last.
+    size_t NextDirty(size_t first, size_t last) const {
+        const uint64_t* dirty = dirty_.template Bottom<uint64_t>();
+        size_t word = first / 64;
+        uint64_t bits = dirty[word] & (~static_cast<uint64_t>(0) << (first % 64));
+        for (;;) {
+            if (bits) {
+                const size_t pos = word * 64 + internal::CountTrailingZeros64(bits);
+                return pos < last ? pos : last;
+            }
+            if (++word * 64 >= last)
+                return last;
+            bits = dirty[word];
+        }
+    }
+
+    static bool ParseHex4(const Ch* p, unsigned& codepoint) {
+        codepoint = 0;
+        for (int k = 0; k < 4; k++) {
+            const Ch c = p[k];
+            codepoint <<= 4;
+            if (c >= '0' && c <= '9')
+                codepoint += static_cast<unsigned>(c - '0');
+            else if (c >= 'A' && c <= 'F')
+                codepoint += static_cast<unsigned>(c - 'A' + 10);
+            else if (c >= 'a' && c <= 'f')
+                codepoint += static_cast<unsigned>(c - 'a' + 10);
+            else
+                return false;
+        }
+        return true;
+    }
+
+    //! Decodes the string [first, last) to \c out, or only checks it if
+    //! \c out is null. Returns the decoded length, or -1 for a control
+    //! character or a malformed escape, which GenericReader then reports.
+    template <typename In>
+    ptrdiff_t Unescape(const In& in, size_t first, size_t last, TargetCh* out) const {
+        static const char escape[256] = {
+            0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,
+            0,0,'\"',0,0,0,0,0, 0,0,0,0,0,0,0,'/', 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,
+            0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,'\\',0,0,0,
+            0,0,'\b',0,0,0,'\f',0, 0,0,0,0,0,0,'\n',0, 0,0,'\r',0,'\t',0,0,0, 0,0,0,0,0,0,0,0,
+        };
+        const Ch* const text = in.base;
+        ptrdiff_t length = 0;
+        size_t p = first;
+        for (;;) {
+            const size_t d = NextDirty(p, last);
+            if (out)
+                std::memmove(out + length, text + p, (d - p) * sizeof(Ch));
+            length += static_cast<ptrdiff_t>(d - p);
+            if (d == last)
+                return length;
+            // The closing quote is not escaped, so an escape ends before it.
+            if (text[d] != '\\')
+                return -1;
+            const unsigned char e = static_cast<unsigned char>(text[d + 1]);
+            if (escape[e]) {
+                if (out)
+                    out[length] = static_cast<TargetCh>(escape[e]);
+                length++;
+                p = d + 2;
+                continue;
+            }
+            unsigned codepoint;
+            if (e != 'u' || d + 6 > last || !ParseHex4(text + d + 2, codepoint))
+                return -1;
+            p = d + 6;
+            if (codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+                unsigned low;
+                if (p + 6 > last || text[p] != '\\' || text[p + 1] != 'u' || !ParseHex4(text + p + 2, low) ||
+                    low < 0xDC00 || low > 0xDFFF)
+                    return -1;
+                codepoint = (((codepoint - 0xD800) << 10) | (low - 0xDC00)) + 0x10000;
+                p += 6;
+            }
+            const ptrdiff_t n = codepoint < 0x80 ? 1 : codepoint < 0x800 ? 2 : codepoint < 0x10000 ? 3 : 4;
+            if (out) {
+                TargetCh* o = out + length;
+                if (n == 1)
+                    o[0] = static_cast<TargetCh>(codepoint);
+                else {
+                    static const unsigned char lead[5] = { 0, 0, 0xC0, 0xE0, 0xF0 };
+                    o[0] = static_cast<TargetCh>(lead[n] | (codepoint >> (6 * (n - 1))));
+                    for (ptrdiff_t k = 1; k < n; k++)
+                        o[k] = static_cast<TargetCh>(0x80 | ((codepoint >> (6 * (n - 1 - k))) & 0x3F));
+                }
+            }
+            length += n;
+        }
+    }
+
+    //! Position of the first significant character at or after \c end,
+    //! the end of a value; entries before it are skipped.
+    template <typename In>
+    size_t Next(const In& in, const uint32_t* positions, size_t& i, size_t end) const {
+        while (positions[i] < end)
+            i++;
+        if (positions[i] == end || IsWhitespace(in.At(end)))
+            return positions[i];
+        // A character glued to a scalar, which GenericReader reports.
+        return end;
+    }
+
+    //! Lets GenericReader parse the value at \c pos.
+    template <unsigned parseFlags, typename In, typename Handler>
+    bool Delegate(In& in, size_t pos, Handler& handler, size_t& end) {
+        in.stream.src_ = in.base + pos;
+        parseResult_ = reader_.template Parse<(parseFlags | kParseStopWhenDoneFlag) & ~static_cast<unsigned>(kParseIterativeFlag)>(in.stream, handler);
+        end = in.stream.Tell();
+        return !parseResult_.IsError();
+    }
+
+    template <unsigned parseFlags, typename In, typename Handler>
+    bool ParseString(In& in, const uint32_t* positions, size_t i, bool isKey, Handler& handler, size_t& end) {
+        const size_t open = positions[i];
+        const size_t close = positions[i + 1];
+        const bool fast = internal::IsSame<SourceEncoding, TargetEncoding>::Value &&
+                          !(parseFlags & kParseValidateEncodingFlag);
+        if (fast && close < in.length && in.At(close) == '\"') {
+            const bool plain = NextDirty(open + 1, close) == close;
+            ptrdiff_t length = static_cast<ptrdiff_t>(close - open - 1);
+            const TargetCh* str = 0;
+            bool copy = false;
+            if (parseFlags & kParseInsituFlag) {
+                TargetCh* text = reinterpret_cast<TargetCh*>(Mutable(in.base + open + 1));
+                // Check before decoding, as GenericReader needs the text
+                // intact to report the error.
+                if (!plain && Unescape(in, open + 1, close, 0) >= 0)
+                    length = Unescape(in, open + 1, close, text);
+                else if (!plain)
+                    length = -1;
+                if (length >= 0)
+                    text[length] = '\0';
+                str = text;
+            }
+            else {
+                TargetCh* buffer = stack_.template Push<TargetCh>(static_cast<size_t>(length) + 1);
+                if (plain)
+                    std::memcpy(buffer, in.base + open + 1, static_cast<size_t>(length) * sizeof(TargetCh));
+                else
+                    length = Unescape(in, open + 1, close, buffer);
+                if (length >= 0)
+                    buffer[length] = '\0';
+                str = buffer;
+                copy = true;
+            }
+            if (length >= 0) {
+                const SizeType n = static_cast<SizeType>(length);
+                const bool cont = isKey ? handler.Key(str, n, copy) : handler.String(str, n, copy);
+                stack_.Clear();
+                end = close + 1;
+                if (RAPIDJSON_UNLIKELY(!cont)) {
+                    parseResult_.Set(kParseErrorTermination, end);
+                    return false;
+                }
+                return true;
+            }
+            stack_.Clear();
+        }
+
+        if (isKey) {
+            KeyHandler<Handler> keyHandler(handler);
+            return Delegate<parseFlags>(in, open, keyHandler, end);
+        }
+        return Delegate<parseFlags>(in, open, handler, end);
+    }
+
+    template <typename In>
+    static bool Match(const In& in, size_t pos, const char* literal, size_t length) {
+        if (pos + length > in.length)
+            return false;
+        for (size_t k = 0; k < length; k++)
+            if (in.base[pos + k] != static_cast<Ch>(literal[k]))
+                return false;
+        return true;
+    }
+
+    // Null, booleans and integers of up to nine digits; anything else goes
+    // to GenericReader.
+    template <unsigned parseFlags, typename In, typename Handler>
+    bool ParseScalar(In& in, size_t pos, Handler& handler, size_t& end) {
+        bool cont = true;
+        switch (in.At(pos)) {
+        case 'n':
+            if (!Match(in, pos, "null", 4))
+                return Delegate<parseFlags>(in, pos, handler, end);
+            end = pos + 4;
+            cont = handler.Null();
+            break;
+        case 't':
+            if (!Match(in, pos, "true", 4))
+                return Delegate<parseFlags>(in, pos, handler, end);
+            end = pos + 4;
+            cont = handler.Bool(true);
+            break;
+        case 'f':
+            if (!Match(in, pos, "false", 5))
+                return Delegate<parseFlags>(in, pos, handler, end);
+            end = pos + 5;
+            cont = handler.Bool(false);
+            break;
+        case '\0':
+            // The end of the text where a value is expected.
+            parseResult_.Set(kParseErrorValueInvalid, pos);
+            return false;
+        default: {
+            if (parseFlags & kParseNumbersAsStringsFlag)
+                return Delegate<parseFlags>(in, pos, handler, end);
+            size_t k = pos;
+            const bool minus = in.At(k) == '-';
+            if (minus)
+                k++;
+            const size_t first = k;
+            unsigned value = 0;
+            while (k - first < 9 && in.At(k) >= '0' && in.At(k) <= '9')
+                value = value * 10 + static_cast<unsigned>(in.At(k++) - '0');
+            const Ch c = in.At(k);
+            if (k == first || (in.At(first) == '0' && k - first > 1) ||
+                (c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E')
+                return Delegate<parseFlags>(in, pos, handler, end);
+            end = k;
+            cont = minus ? handler.Int(static_cast<int32_t>(~value + 1)) : handler.Uint(value);
+            if (RAPIDJSON_UNLIKELY(!cont)) {
+                parseResult_.Set(kParseErrorTermination, pos);
+                return false;
+            }
+            return true;
+        }
+        }
+        if (RAPIDJSON_UNLIKELY(!cont)) {
+            parseResult_.Set(kParseErrorTermination, end);
+            return false;
+        }
+        return true;
+    }
+
+    template <unsigned parseFlags, typename In, typename Handler>
+    ParseResult ParseInput(In& in, Handler& handler) {
+        parseResult_.Clear();
+        if ((parseFlags & kParseCommentsFlag) || in.length >= 0xFFFFFFFFu) {
+            parseResult_ = reader_.template Parse<parseFlags>(in.stream, handler);
+            return parseResult_;
+        }
+
+        ClearStacksOnExit scope(*this);
+        BuildIndex(in.base, in.length);
+        const uint32_t* positions = positions_.template Bottom<uint32_t>();
+
+        enum State { kValue, kKey, kAfterValue };
+        State state = kValue;
+        size_t i = 0;
+        size_t p = positions[0];
+        size_t end = 0;
+
+        if (RAPIDJSON_UNLIKELY(in.At(p) == '\0')) {
+            parseResult_.Set(kParseErrorDocumentEmpty, p);
+            return parseResult_;
+        }
+
+#define RAPIDJSON_STRUCTURAL_ERROR(code, offset) \
+        RAPIDJSON_MULTILINEMACRO_BEGIN \
+        parseResult_.Set(code, offset); \
+        return parseResult_; \
+        RAPIDJSON_MULTILINEMACRO_END
+
+        for (;;) {
+            switch (state) {
+            case kValue:
+                // p == positions[i], the first character of the value.
+                switch (in.At(p)) {
+                case '{':
+                    i++;
+                    if (RAPIDJSON_UNLIKELY(!handler.StartObject()))
+                        RAPIDJSON_STRUCTURAL_ERROR(kParseErrorTermination, p + 1);
+                    p = positions[i];
+                    if (in.At(p) == '}') {
+                        i++;
+                        if (RAPIDJSON_UNLIKELY(!handler.EndObject(0)))
+                            RAPIDJSON_STRUCTURAL_ERROR(kParseErrorTermination, p + 1);
+                        end = p + 1;
+                        state = kAfterValue;
+                    }
+                    else {
+                        Container* c = containers_.template Push<Container>();
+                        c->count = 0;
+                        c->object = true;
+                        state = kKey;
+                    }
+                    break;
+                case '[':
+                    i++;
+                    if (RAPIDJSON_UNLIKELY(!handler.StartArray()))
+                        RAPIDJSON_STRUCTURAL_ERROR(kParseErrorTermination, p + 1);
+                    p = positions[i];
+                    if (in.At(p) == ']') {
+                        i++;
+                        if (RAPIDJSON_UNLIKELY(!handler.EndArray(0)))
+                            RAPIDJSON_STRUCTURAL_ERROR(kParseErrorTermination, p + 1);
+                        end = p + 1;
+                        state = kAfterValue;
+                    }
+                    else {
+                        Container* c = containers_.template Push<Container>();
+                        c->count = 0;
+                        c->object = false;
+                    }
+                    break;
+                case '\"':
+                    if (!ParseString<parseFlags>(in, positions, i, false, handler, end))
+                        return parseResult_;
+                    state = kAfterValue;
+                    break;
+                default:
+                    if (!ParseScalar<parseFlags>(in, p, handler, end))
+                        return parseResult_;
+                    state = kAfterValue;
+                    break;
+                }
+                break;
+
+            case kKey:
+                if (RAPIDJSON_UNLIKELY(in.At(p) != '\"'))
+                    RAPIDJSON_STRUCTURAL_ERROR(kParseErrorObjectMissName, p);
+                if (!ParseString<parseFlags>(in, positions, i, true, handler, end))
+                    return parseResult_;
+                p = Next(in, positions, i, end);
+                if (RAPIDJSON_UNLIKELY(in.At(p) != ':'))
+                    RAPIDJSON_STRUCTURAL_ERROR(kParseErrorObjectMissColon, p);
+                p = positions[++i];
+                state = kValue;
+                break;
+
+            case kAfterValue: {
+                if (containers_.Empty()) {
+                    if (!(parseFlags & kParseStopWhenDoneFlag)) {
+                        p = Next(in, positions, i, end);
+                        if (RAPIDJSON_UNLIKELY(in.At(p) != '\0'))
+                            RAPIDJSON_STRUCTURAL_ERROR(kParseErrorDocumentRootNotSingular, p);
+                    }
+                    return parseResult_;
+                }
+
+                Container* c = containers_.template Top<Container>();
+                c->count++;
+                p = Next(in, positions, i, end);
+                const Ch close = c->object ? '}' : ']';
+                if (in.At(p) == ',') {
+                    p = positions[++i];
+                    if ((parseFlags & kParseTrailingCommasFlag) && in.At(p) == close) {
+                        if (RAPIDJSON_UNLIKELY(!(c->object ? handler.EndObject(c->count) : handler.EndArray(c->count))))
+                            RAPIDJSON_STRUCTURAL_ERROR(kParseErrorTermination, p);
+                        i++;
+                        end = p + 1;
+                        containers_.template Pop<Container>(1);
+                    }
+                    else
+                        state = c->object ? kKey : kValue;
+                }
+                else if (in.At(p) == close) {
+                    i++;
+                    if (RAPIDJSON_UNLIKELY(!(c->object ? handler.EndObject(c->count) : handler.EndArray(c->count))))
+                        RAPIDJSON_STRUCTURAL_ERROR(kParseErrorTermination, p + 1);
+                    end = p + 1;
+                    containers_.template Pop<Container>(1);
+                }
+                else
+                    RAPIDJSON_STRUCTURAL_ERROR(c->object ? kParseErrorObjectMissCommaOrCurlyBracket
+                                                         : kParseErrorArrayMissCommaOrSquareBracket, p);
+                break;
+            }
+            }
+        }
+#undef RAPIDJSON_STRUCTURAL_ERROR
+    }
+
+    static const size_t kDefaultStackCapacity = 256;    //!< Default capacity in bytes of each stack.
+    ReaderType reader_;                         //!< Parses everything not handled from the index.
+    internal::Stack<StackAllocator> positions_; //!< Structural positions (uint32_t).
+    internal::Stack<StackAllocator> dirty_;     //!< Escapes and control characters in strings, one bit per byte.
+    internal::Stack<StackAllocator> containers_;
+    internal::Stack<StackAllocator> stack_;     //!< Copies of strings.
+    ParseResult parseResult_;
+}; // class GenericStructuralReader
+
+//! StructuralReader with UTF8 encoding and default allocator.
+typedef GenericStructuralReader<UTF8<>, UTF8<> > StructuralReader;
+
+RAPIDJSON_NAMESPACE_END
+
+#undef RAPIDJSON_STRUCTURAL_SSE2
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_POP
+#endif
+
+#endif // RAPIDJSON_STRUCTURALREADER_H_
@@ -0,0 +1,175 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  // struct ucred
+#endif
+
+#include "zygote.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <vector>
+
+#include "logger.h"
+
+namespace {
+
+bool MakeAddress(const std::string& path, struct sockaddr_un* addr) {
+  memset(addr, 0, sizeof(*addr));
+  addr->sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(addr->sun_path)) {
+    LOG_ERROR("Invalid zygote socket path: %s", path.c_str());
+    return false;
+  }
+  memcpy(addr->sun_path, path.c_str(), path.size());
+  return true;
+}
+
+}  // namespace
+
+Zygote::Zygote(const std::string& socket_path) : socket_path_(socket_path) {}
+
+Zygote::~Zygote() {
+  if (listen_fd_ >= 0) {
+    close(listen_fd_);
+  }
+}
+
+bool Zygote::Listen() {
+  struct sockaddr_un addr;
+  if (!MakeAddress(socket_path_, &addr))
+    return false;
+
+  listen_fd_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (listen_fd_ < 0) {
+    LOG_ERROR("Failed to create zygote socket: %s", strerror(errno));
+    return false;
+  }
+
+  // A stale socket from a previous zygote would make bind() fail.
+  unlink(socket_path_.c_str());
+  if (bind(listen_fd_, reinterpret_cast<struct sockaddr*>(&addr),
+           sizeof(addr)) < 0 ||
+      chmod(socket_path_.c_str(), S_IRUSR | S_IWUSR) < 0 ||
+      listen(listen_fd_, SOMAXCONN) < 0) {
+    LOG_ERROR("Failed to listen on %s: %s", socket_path_.c_str(),
+              strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool Zygote::IsTrustedPeer(int fd) {
+  struct ucred cred;
+  socklen_t len = sizeof(cred);
+  if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) < 0) {
+    return false;
+  }
+  return cred.uid == getuid();
+}
+
+int Zygote::Serve(const LaunchCallback& launch) {
+  if (!Listen())
+    return -1;
+
+  // Children are not waited for; let the kernel reap them.
+  signal(SIGCHLD, SIG_IGN);
+
+  LOG_INFO("Zygote ready on %s", socket_path_.c_str());
+  std::vector<char> buffer(kMaxRequestSize);
+  for (;;) {
+    int conn = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (conn < 0) {
+      if (errno == EINTR)
+        continue;
+      LOG_ERROR("Zygote accept failed: %s", strerror(errno));
+      return -1;
+    }
+
+    if (!IsTrustedPeer(conn)) {
+      LOG_WARNING("Rejected zygote request from foreign uid");
+      close(conn);
+      continue;
+    }
+
+    // Requests are single packets; a truncated one would be launched as
+    // a different, cut off command line.
+    struct iovec iov = {buffer.data(), buffer.size()};
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    ssize_t size = recvmsg(conn, &msg, 0);
+    if (size <= 0) {
+      close(conn);
+      continue;
+    }
+    if (msg.msg_flags & MSG_TRUNC) {
+      LOG_WARNING("Rejected zygote request over %zu bytes", buffer.size());
+      close(conn);
+      continue;
+    }
+    std::string request(buffer.data(), static_cast<size_t>(size));
+
+    pid_t pid = fork();
+    if (pid < 0) {
+      LOG_ERROR("Zygote fork failed: %s", strerror(errno));
+      close(conn);
+      continue;
+    }
+
+    if (pid == 0) {
+      // Child: drop the zygote state and continue as a regular launch.
+      close(listen_fd_);
+      listen_fd_ = -1;
+      signal(SIGCHLD, SIG_DFL);
+
+      std::string reply = std::to_string(getpid());
+      send(conn, reply.c_str(), reply.size(), MSG_NOSIGNAL);
+      close(conn);
+
+      return launch(request);
+    }
+
+    close(conn);
+    LOG_INFO("Zygote forked %d", static_cast<int>(pid));
+  }
+}
+
+int Zygote::Launch(const std::string& socket_path, const std::string& request) {
+  struct sockaddr_un addr;
+  if (!MakeAddress(socket_path, &addr))
+    return -1;
+
+  int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    return -1;
+  }
+
+  int pid = -1;
+  if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) ==
+          0 &&
+      send(fd, request.c_str(), request.size(), MSG_NOSIGNAL) ==
+          static_cast<ssize_t>(request.size())) {
+    char reply[32] = {};
+    if (recv(fd, reply, sizeof(reply) - 1, 0) > 0) {
+      pid = atoi(reply);
+    }
+  } else {
+    LOG_ERROR("Failed to reach zygote on %s: %s", socket_path.c_str(),
+              strerror(errno));
+  }
+
+  close(fd);
+  return pid;
+}
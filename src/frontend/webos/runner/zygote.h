@@ -0,0 +1,49 @@
+// Copyright (c) 2025 LG Electronics, Inc. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_RUNNER_ZYGOTE_H_
+#define FLUTTER_RUNNER_ZYGOTE_H_
+
+#include <functional>
+#include <string>
+
+// Prewarmed launcher process.
+//
+// The zygote is started once with the embedder and plugin libraries already
+// loaded and the platform settings parsed. It then waits on a local unix
+// socket for launch requests (the client's command line arguments,
+// NUL-separated) and forks a child per request, so a launch only pays for
+// the app specific part of startup.
+class Zygote {
+ public:
+  // Called in the forked child with the launch request. Its return value
+  // becomes the child's exit code.
+  using LaunchCallback = std::function<int(const std::string& request)>;
+
+  static constexpr size_t kMaxRequestSize = 64 * 1024;
+
+  explicit Zygote(const std::string& socket_path);
+  ~Zygote();
+
+  // Prevent copying.
+  Zygote(Zygote const&) = delete;
+  Zygote& operator=(Zygote const&) = delete;
+
+  // Serves launch requests forever. Returns in forked children with the
+  // result of |launch|, or in the zygote itself with -1 on a fatal error.
+  int Serve(const LaunchCallback& launch);
+
+  // Client side: sends |request| to the zygote listening on |socket_path|
+  // and returns the pid of the launched child, or -1.
+  static int Launch(const std::string& socket_path, const std::string& request);
+
+ private:
+  bool Listen();
+  bool IsTrustedPeer(int fd);
+
+  std::string socket_path_;
+  int listen_fd_ = -1;
+};
+
+#endif  // FLUTTER_RUNNER_ZYGOTE_H_